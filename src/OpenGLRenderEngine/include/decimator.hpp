@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "scl/rmq.hpp"
+
+// Level-of-detail source for uniformly sampled series: for a visible x-range
+// split into pixel columns it emits the min and max of every column. The
+// samples are grouped into buckets of 64 with an RMQ over the bucket minima
+// and maxima, so a column costs two O(1) queries plus a scan of at most two
+// partial buckets, and the per-frame cost depends on pixels, not samples.
+// Memory is the samples plus about 2 * 20 B per bucket: 4.6 B per float,
+// some 460 MB for 10^8 samples, where per-sample RMQs would take 4 GB.
+template<class T>
+class MinMaxDecimator {
+public:
+    static constexpr std::size_t bucket = 64;
+
+    struct Envelope {
+        std::vector<double> x, lo, hi;
+
+        void clear() {
+            x.clear();
+            lo.clear();
+            hi.clear();
+        }
+    };
+
+    // Takes the samples by value so callers can move them in. `progress`
+    // runs from 0 to 1 over the bucket pass.
+    MinMaxDecimator(std::vector<T> ys, double x0, double dx, const std::function<void(float)>& progress = nullptr)
+        : x0_(x0), dx_(dx), ys_(std::move(ys)) {
+        const std::size_t buckets = (ys_.size() + bucket - 1) / bucket;
+        std::vector<T> mins(buckets), maxs(buckets);
+        for (std::size_t b = 0; b < buckets; ++b) {
+            const auto first = ys_.begin() + static_cast<std::ptrdiff_t>(b * bucket);
+            const auto last = ys_.begin() + static_cast<std::ptrdiff_t>(std::min(ys_.size(), (b + 1) * bucket));
+            const auto [mn, mx] = std::minmax_element(first, last);
+            mins[b] = *mn;
+            maxs[b] = *mx;
+            if (progress && b % (1 << 16) == 0) {
+                progress(static_cast<float>(b) / static_cast<float>(buckets));
+            }
+        }
+        min_.init(mins);
+        max_.init(maxs);
+        if (progress) {
+            progress(1.0f);
+        }
+    }
+
+    std::size_t size() const {
+        return ys_.size();
+    }
+
+    double xBegin() const {
+        return x0_;
+    }
+
+    double xEnd() const {
+        return x0_ + dx_ * static_cast<double>(size());
+    }
+
+    void decimate(double x0, double x1, int columns, Envelope& out) const {
+        out.clear();
+        const std::size_t n = size();
+        if (n == 0 || columns <= 0 || !(x1 > x0)) {
+            return;
+        }
+
+        const double width = (x1 - x0) / columns;
+        auto indexAt = [&](double x) {
+            return static_cast<std::size_t>(std::clamp(std::ceil((x - x0_) / dx_), 0.0, static_cast<double>(n)));
+        };
+
+        std::size_t lo = indexAt(x0);
+        for (int c = 0; c < columns && lo < n; ++c) {
+            const std::size_t hi = indexAt(x0 + (c + 1) * width);
+            if (lo < hi) {
+                const auto [mn, mx] = minMax(lo, hi);
+                out.x.push_back(x0_ + dx_ * static_cast<double>(lo + hi - 1) * 0.5);
+                out.lo.push_back(static_cast<double>(mn));
+                out.hi.push_back(static_cast<double>(mx));
+            }
+            lo = std::max(lo, hi);
+        }
+    }
+
+private:
+    // Min and max of the samples [lo, hi), lo < hi: whole buckets through
+    // the RMQs, the partial ones at either end by scanning.
+    std::pair<T, T> minMax(std::size_t lo, std::size_t hi) const {
+        const std::size_t b1 = (lo + bucket - 1) / bucket;
+        const std::size_t b2 = hi / bucket;
+        if (b1 >= b2) {
+            return scan(lo, hi, ys_[lo], ys_[lo]);
+        }
+        T mn = min_(static_cast<int>(b1), static_cast<int>(b2));
+        T mx = max_(static_cast<int>(b1), static_cast<int>(b2));
+        std::tie(mn, mx) = scan(lo, b1 * bucket, mn, mx);
+        return scan(b2 * bucket, hi, mn, mx);
+    }
+
+    std::pair<T, T> scan(std::size_t lo, std::size_t hi, T mn, T mx) const {
+        for (std::size_t i = lo; i < hi; ++i) {
+            mn = std::min(mn, ys_[i]);
+            mx = std::max(mx, ys_[i]);
+        }
+        return {mn, mx};
+    }
+
+    double x0_;
+    double dx_;
+    std::vector<T> ys_;
+    RMQ<T, std::less<T>> min_;
+    RMQ<T, std::greater<T>> max_;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <deque>
+#include <vector>
+
+// GL_TIME_ELAPSED queries kept in flight for a few frames and read back only
+// once available, so measuring never stalls the pipeline.
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+    ~GpuTimer();
+
+    void begin();
+    void end();
+
+    // Appends the durations (ms) of finished queries to `out`, oldest first.
+    // With `block` it waits for every query still in flight.
+    void collect(std::vector<double>& out, bool block = false);
+
+private:
+    std::vector<GLuint> free_;
+    std::deque<GLuint> inFlight_;
+    GLuint active_{};
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <filesystem>
+#include <span>
+
+namespace headless {
+
+struct Options {
+    bool enabled = false;
+    int frames = 1000;
+    int width = 1280;
+    int height = 720;
+    std::filesystem::path report = "frame_report.json";
+};
+
+// --headless [--frames N] [--size WxH] [--report file.json]
+Options parseArgs(int argc, char** argv);
+
+// Offscreen RGBA8 color + depth target standing in for the default framebuffer.
+class Framebuffer {
+public:
+    Framebuffer(int width, int height);
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+    ~Framebuffer();
+
+    void bind() const;
+
+private:
+    GLuint fbo_{};
+    GLuint color_{};
+    GLuint depth_{};
+    int width_{};
+    int height_{};
+};
+
+struct FrameSample {
+    double cpuMs{};
+    double gpuMs{};
+};
+
+void writeReport(const Options& options, std::span<const FrameSample> samples, double totalSeconds);
+
+}  // namespace headless
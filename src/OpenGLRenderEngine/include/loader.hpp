@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "scl/ringqueue.hpp"
+
+// Worker thread owning a hidden GLFW window whose context shares objects with
+// the render context. Jobs decode and upload on that thread; what they hand
+// back is run on the render thread by poll() once a fence placed after the
+// uploads has signaled, so the render thread never waits on a transfer.
+class Loader {
+public:
+    enum class State {
+        Queued,
+        Running,
+        Uploading,
+        Done,
+        Failed,
+    };
+
+    struct Status {
+        std::string name;
+        std::atomic<float> progress{0.0f};
+        std::atomic<State> state{State::Queued};
+        // Set by a job that creates GL objects, to free them when its callback
+        // never runs: the job threw, or the Loader shut down first.
+        std::function<void()> discard;
+
+        void report(float fraction) {
+            progress.store(fraction, std::memory_order_relaxed);
+        }
+    };
+
+    // Runs on the loader thread with the shared context current. The returned
+    // callback, if any, runs on the render thread when the uploads are visible.
+    using Job = std::function<std::function<void()>(Status&)>;
+
+    explicit Loader(GLFWwindow* share);
+    Loader(const Loader&) = delete;
+    Loader& operator=(const Loader&) = delete;
+    ~Loader();
+
+    void submit(std::string name, Job job);
+
+    // Render thread, once per frame. Returns whether any job completed.
+    bool poll();
+    // Polls until every submitted job has finished.
+    void waitIdle();
+
+    bool idle() const;
+    void drawUi();
+
+private:
+    struct Request {
+        std::shared_ptr<Status> status;
+        Job job;
+    };
+
+    struct Completion {
+        std::shared_ptr<Status> status;
+        std::function<void()> ready;
+        GLsync fence{};
+    };
+
+    void run();
+
+    GLFWwindow* context_{};
+    scl::SpscQueue<Request> requests_{256};
+    scl::SpscQueue<Completion> completions_{256};
+    std::vector<Completion> pending_;
+    std::vector<std::shared_ptr<Status>> statuses_;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
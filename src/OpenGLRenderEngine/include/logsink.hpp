@@ -0,0 +1,91 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+#include "scl/cacheline.hpp"
+#include "scl/ringqueue.hpp"
+
+// Asynchronous front end for an spdlog logger. log() filters by severity,
+// rate-limits each message id through a lock-free table and copies the text
+// into a fixed-size record on an scl::MpmcQueue, marking text cut at
+// maxMessage bytes with a trailing ellipsis; a background thread does the
+// formatting and I/O. Nothing on the calling thread locks, allocates or
+// blocks, so it is safe from GL debug callbacks on driver threads.
+class LogSink {
+public:
+    using Level = spdlog::level::level_enum;
+
+    struct Options {
+        Level level = Level::info;
+        // at most `burst` messages per id and window; the rest are counted
+        int burst = 5;
+        std::chrono::milliseconds window{1000};
+        std::size_t capacity = 4096;
+    };
+
+    explicit LogSink(std::shared_ptr<spdlog::logger> logger, Options options);
+    explicit LogSink(std::shared_ptr<spdlog::logger> logger) : LogSink(std::move(logger), Options{}) {}
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+    ~LogSink();
+
+    // Any thread. `id` groups repeats of one message, e.g. a GL debug
+    // message id; 0 is free text and is never rate-limited, since unique
+    // lines would only fill the table.
+    void log(Level level, std::uint64_t id, std::string_view message);
+
+    void log(Level level, std::string_view message) {
+        log(level, 0, message);
+    }
+
+    void setLevel(Level level) {
+        level_.store(level, std::memory_order_relaxed);
+    }
+
+    bool enabled(Level level) const {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t maxMessage = 240;
+    static constexpr std::size_t tableSize = 1024;
+    static constexpr std::size_t maxProbe = 16;
+
+    struct Record {
+        Level level{};
+        bool stop{};
+        std::uint32_t suppressed{};
+        std::uint32_t length{};
+        std::array<char, maxMessage> text{};
+    };
+
+    struct alignas(scl::cacheLineSize) Entry {
+        std::atomic<std::uint64_t> id{0};
+        std::atomic<std::int64_t> windowStart{0};
+        std::atomic<std::uint32_t> count{0};
+        std::atomic<std::uint32_t> suppressed{0};
+    };
+
+    // Claims or finds the entry for `id` within maxProbe slots of its home;
+    // nullptr when they all hold other ids, and the message goes unlimited.
+    Entry* entryFor(std::uint64_t id);
+    void run();
+
+    std::shared_ptr<spdlog::logger> logger_;
+    std::atomic<Level> level_;
+    int burst_;
+    std::int64_t windowNs_;
+    std::unique_ptr<Entry[]> table_;
+    scl::MpmcQueue<Record> queue_;
+    std::atomic<std::uint64_t> dropped_{0};
+    std::thread writer_;
+};
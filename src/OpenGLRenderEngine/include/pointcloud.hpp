@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+#include "streambuffer.hpp"
+
+struct PointVertex {
+    float x, y, z;
+    // scalar in [0, 1] mapped through the Jet colormap
+    float value;
+};
+
+// Streams points straight into persistently mapped memory and draws every
+// batch of a frame with a single glMultiDrawArraysIndirect.
+class PointCloudRenderer {
+public:
+    explicit PointCloudRenderer(std::size_t maxPoints, std::size_t maxBatches = 64);
+    PointCloudRenderer(const PointCloudRenderer&) = delete;
+    PointCloudRenderer& operator=(const PointCloudRenderer&) = delete;
+    ~PointCloudRenderer();
+
+    // Storage for this frame's points; valid until draw().
+    std::span<PointVertex> begin();
+    // Records the points [first, first + count) of begin()'s span as one draw.
+    // Past maxBatches the range is merged into the last draw, so it must
+    // continue where that one ends.
+    void addBatch(std::size_t first, std::size_t count);
+    // mvp is column-major.
+    void draw(const std::array<float, 16>& mvp, float pointSize);
+
+    double stallMs() const {
+        return vertices_.stallMs() + commands_.stallMs();
+    }
+
+private:
+    struct DrawArraysIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    StreamBuffer vertices_;
+    StreamBuffer commands_;
+    std::span<DrawArraysIndirectCommand> batches_;
+    std::size_t batchCount_{};
+    GLuint baseVertex_{};
+    GLuint vao_{};
+    GLuint program_{};
+    GLint mvpLocation_{};
+    GLint pointSizeLocation_{};
+};
+
+// Animated height field regenerated on the CPU every frame, to exercise the
+// streaming path at tens of millions of points per second.
+class PointCloudDemo {
+public:
+    explicit PointCloudDemo(int maxSide = 1024);
+
+    // Advances the animation by `dt` seconds; any thread. Returns false when
+    // there is nothing to animate, so callers need not request a redraw.
+    bool advance(double dt);
+
+    void render();
+    void drawUi();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    PointCloudRenderer renderer_;
+    int maxSide_;
+    int side_;
+    int strips_{8};
+    float pointSize_{1.5f};
+    bool enabled_{true};
+    // off by default: while animating, every tick asks for a redraw and the
+    // app never idles
+    bool animate_{false};
+    std::atomic<bool> animating_{false};
+    std::atomic<float> time_{};
+    double fillMs_{};
+    // points drawn per second over the last half-second window of frames
+    Clock::time_point windowStart_{Clock::now()};
+    double windowPoints_{};
+    double pointsPerSecond_{};
+};
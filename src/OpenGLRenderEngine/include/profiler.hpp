@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "gputimer.hpp"
+
+// Per-phase CPU times of the main loop plus GPU times for the phases that
+// issue GL work, kept over a rolling window and drawn with ImPlot.
+class FrameProfiler {
+public:
+    enum class Phase {
+        Poll,
+        Loader,
+        Input,
+        Clear,
+        Scene,
+        ImGuiBuild,
+        Render,
+        Swap,
+        Count,
+    };
+    static constexpr std::size_t phaseCount = static_cast<std::size_t>(Phase::Count);
+
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, Phase phase) : profiler_(profiler), phase_(phase) {
+            profiler_.begin(phase_);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() {
+            profiler_.end(phase_);
+        }
+
+    private:
+        FrameProfiler& profiler_;
+        Phase phase_;
+    };
+
+    explicit FrameProfiler(bool gpuTiming = true, std::size_t history = 600);
+
+    void beginFrame();
+    void endFrame();
+
+    void begin(Phase phase);
+    void end(Phase phase);
+
+    Scope scope(Phase phase) {
+        return Scope{*this, phase};
+    }
+
+    void draw();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Series {
+        std::vector<float> values;
+        std::size_t next{};
+        // samples pushed so far, up to values.size(); the rest are padding
+        std::size_t filled{};
+
+        void push(float value);
+        void ordered(std::vector<float>& out) const;
+    };
+
+    static bool isGpuPhase(Phase phase);
+
+    bool gpuTiming_;
+    std::size_t history_;
+    Clock::time_point frameStart_;
+    std::array<Clock::time_point, phaseCount> phaseStart_{};
+    std::array<float, phaseCount> cpuFrame_{};
+    std::array<Series, phaseCount> cpu_;
+    std::array<Series, phaseCount> gpu_;
+    std::array<GpuTimer, phaseCount> gpuTimers_;
+    Series frame_;
+    std::vector<double> gpuResults_;
+};
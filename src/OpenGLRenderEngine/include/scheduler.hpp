@@ -0,0 +1,91 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+// Decides when the main loop draws. Input, resizes and explicit requests mark
+// the next few frames dirty; otherwise the thread sleeps in glfwWaitEvents
+// instead of redrawing an unchanged screen. With a target frame rate, frames
+// are paced by waiting for events until just before the deadline and
+// spinning the rest, which is far more precise than sleeping alone.
+//
+// Construct before imgui::init so the ImGui GLFW backend chains the
+// callbacks installed here, and destroy after imgui::destroy but before the
+// window.
+class FrameScheduler {
+public:
+    // ImGui needs a couple of frames after an event to settle hover state,
+    // popups and the like.
+    static constexpr int settleFrames = 3;
+
+    explicit FrameScheduler(GLFWwindow* window);
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+    ~FrameScheduler();
+
+    // Any thread. Off the main thread it also wakes the event wait, unless
+    // the window is iconified and nothing would be drawn anyway.
+    void requestRedraw(int frames = settleFrames);
+
+    // Blocks in the event wait until a frame should be drawn or the window
+    // should close. Events that arrive in the final stretch are left for the
+    // caller's glfwPollEvents, so the frame profiler can time that call.
+    void waitForFrame();
+
+    // 0 leaves pacing to vsync; any other target turns vsync off. Main
+    // thread, with the window's context current.
+    void setTargetFps(double fps);
+
+    void drawUi();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static FrameScheduler& from(GLFWwindow* window);
+    void installCallbacks();
+
+    GLFWwindow* window_;
+    std::thread::id mainThread_{std::this_thread::get_id()};
+    std::atomic<int> pending_{settleFrames};
+    std::atomic<bool> iconified_{false};
+    bool continuous_{};
+    float targetFps_{};
+    Clock::duration period_{};
+    Clock::time_point nextFrame_{Clock::now()};
+    long long framesDrawn_{};
+    long long wakeups_{};
+
+    GLFWframebuffersizefun prevFramebufferSize_{};
+    GLFWwindowrefreshfun prevRefresh_{};
+    GLFWwindowfocusfun prevFocus_{};
+    GLFWwindowiconifyfun prevIconify_{};
+    GLFWcursorposfun prevCursorPos_{};
+    GLFWmousebuttonfun prevMouseButton_{};
+    GLFWscrollfun prevScroll_{};
+    GLFWkeyfun prevKey_{};
+    GLFWcharfun prevChar_{};
+};
+
+// Runs `tick` at a fixed rate on its own thread, independent of how often
+// frames are drawn. Late ticks are run back to back to catch up, up to a
+// limit, so the simulation advances in fixed steps.
+class FixedTicker {
+public:
+    FixedTicker(std::chrono::nanoseconds period, std::function<void(double)> tick);
+    FixedTicker(const FixedTicker&) = delete;
+    FixedTicker& operator=(const FixedTicker&) = delete;
+    ~FixedTicker();
+
+private:
+    std::chrono::nanoseconds period_;
+    std::function<void(double)> tick_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+// Sleeps until shortly before `deadline`, then spins until it.
+void sleepUntilPrecise(std::chrono::steady_clock::time_point deadline);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Ring of `regions` equal slices of one immutable, persistently and coherently
+// mapped buffer. The CPU fills one slice while the GPU still reads the others;
+// each slice is fenced on release() and only waited on when it comes round
+// again, so steady-state streaming never reallocates or stalls the driver.
+class StreamBuffer {
+public:
+    static constexpr GLsizeiptr alignment = 256;
+
+    explicit StreamBuffer(GLsizeiptr regionSize, int regions = 3);
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+    ~StreamBuffer();
+
+    // Moves to the next slice, waiting for the GPU to finish with it if needed.
+    std::span<std::byte> acquire();
+    // Fences the current slice; call after the commands that read it.
+    void release();
+
+    template<typename T>
+    std::span<T> acquireAs() {
+        const auto bytes = acquire();
+        return {reinterpret_cast<T*>(bytes.data()), bytes.size() / sizeof(T)};
+    }
+
+    GLuint buffer() const {
+        return buffer_;
+    }
+
+    // Byte offset of the current slice within buffer().
+    GLintptr offset() const {
+        return static_cast<GLintptr>(current_) * regionSize_;
+    }
+
+    GLsizeiptr regionSize() const {
+        return regionSize_;
+    }
+
+    // Time the last acquire() spent waiting on its fence; nonzero means the
+    // GPU is more than `regions - 1` frames behind.
+    double stallMs() const {
+        return stallMs_;
+    }
+
+private:
+    GLsizeiptr regionSize_;
+    GLuint buffer_{};
+    std::byte* mapping_{};
+    std::vector<GLsync> fences_;
+    int current_{-1};
+    double stallMs_{};
+};
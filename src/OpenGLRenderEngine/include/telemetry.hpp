@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "decimator.hpp"
+
+using TelemetrySeries = MinMaxDecimator<float>;
+
+// `progress` covers generating the samples up to 0.9 and bucketing them for
+// the rest. The series keeps about 4.6 B per sample (see MinMaxDecimator).
+TelemetrySeries makeSyntheticSeries(std::size_t n, const std::function<void(float)>& progress = nullptr);
+
+// ImPlot window showing a decimated series; only the visible range at the
+// current plot width is ever handed to ImPlot.
+class TelemetryView {
+public:
+    void setSeries(std::unique_ptr<TelemetrySeries> series);
+    void draw();
+
+private:
+    std::unique_ptr<TelemetrySeries> series_;
+    TelemetrySeries::Envelope envelope_;
+};
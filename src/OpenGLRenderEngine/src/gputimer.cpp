@@ -0,0 +1,47 @@
+#include "gputimer.hpp"
+
+GpuTimer::~GpuTimer() {
+    std::vector<GLuint> all(free_.begin(), free_.end());
+    all.insert(all.end(), inFlight_.begin(), inFlight_.end());
+    if (active_ != 0) {
+        all.push_back(active_);
+    }
+    if (!all.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(all.size()), all.data());
+    }
+}
+
+void GpuTimer::begin() {
+    if (free_.empty()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        free_.push_back(query);
+    }
+    active_ = free_.back();
+    free_.pop_back();
+    glBeginQuery(GL_TIME_ELAPSED, active_);
+}
+
+void GpuTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    inFlight_.push_back(active_);
+    active_ = 0;
+}
+
+void GpuTimer::collect(std::vector<double>& out, bool block) {
+    while (!inFlight_.empty()) {
+        const GLuint query = inFlight_.front();
+        if (!block) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE) {
+                break;
+            }
+        }
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+        out.push_back(static_cast<double>(ns) * 1e-6);
+        inFlight_.pop_front();
+        free_.push_back(query);
+    }
+}
@@ -0,0 +1,146 @@
+#include "headless.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+namespace headless {
+
+namespace {
+
+[[noreturn]] void usage(std::string_view error) {
+    std::cerr << std::format("{}\nusage: OpenGLRenderEngine [--headless [--frames N] [--size WxH] [--report file.json]]", error) << std::endl;
+    std::exit(-1);
+}
+
+int parseInt(std::string_view text, std::string_view what) {
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || ptr != text.data() + text.size() || value <= 0) {
+        usage(std::format("Invalid {}: '{}'", what, text));
+    }
+    return value;
+}
+
+nlohmann::json summarize(std::vector<double> values) {
+    if (values.empty()) {
+        return nullptr;
+    }
+    std::sort(values.begin(), values.end());
+    auto percentile = [&](double p) {
+        return values[static_cast<std::size_t>(p * static_cast<double>(values.size() - 1))];
+    };
+    return {
+        {"mean", std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size())},
+        {"min", values.front()},
+        {"p50", percentile(0.50)},
+        {"p95", percentile(0.95)},
+        {"p99", percentile(0.99)},
+        {"max", values.back()},
+    };
+}
+
+}  // namespace
+
+Options parseArgs(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                usage(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--headless") {
+            options.enabled = true;
+        } else if (arg == "--frames") {
+            options.frames = parseInt(next(), "frame count");
+        } else if (arg == "--size") {
+            std::string_view size = next();
+            auto x = size.find('x');
+            if (x == std::string_view::npos) {
+                usage(std::format("Invalid size: '{}'", size));
+            }
+            options.width = parseInt(size.substr(0, x), "width");
+            options.height = parseInt(size.substr(x + 1), "height");
+        } else if (arg == "--report") {
+            options.report = next();
+        } else {
+            usage(std::format("Unknown argument: '{}'", arg));
+        }
+    }
+    return options;
+}
+
+Framebuffer::Framebuffer(int width, int height) : width_(width), height_(height) {
+    glGenFramebuffers(1, &fbo_);
+    glGenRenderbuffers(1, &color_);
+    glGenRenderbuffers(1, &depth_);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, color_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Offscreen framebuffer is incomplete" << std::endl;
+        std::exit(-1);
+    }
+}
+
+Framebuffer::~Framebuffer() {
+    glDeleteFramebuffers(1, &fbo_);
+    glDeleteRenderbuffers(1, &color_);
+    glDeleteRenderbuffers(1, &depth_);
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glViewport(0, 0, width_, height_);
+}
+
+void writeReport(const Options& options, std::span<const FrameSample> samples, double totalSeconds) {
+    std::vector<double> cpu, gpu;
+    nlohmann::json frames = nlohmann::json::array();
+    for (const auto& sample : samples) {
+        cpu.push_back(sample.cpuMs);
+        gpu.push_back(sample.gpuMs);
+        frames.push_back({{"cpuMs", sample.cpuMs}, {"gpuMs", sample.gpuMs}});
+    }
+
+    nlohmann::json report = {
+        {"renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER))},
+        {"version", reinterpret_cast<const char*>(glGetString(GL_VERSION))},
+        {"width", options.width},
+        {"height", options.height},
+        {"frames", samples.size()},
+        {"totalSeconds", totalSeconds},
+        {"framesPerSecond", totalSeconds > 0 ? static_cast<double>(samples.size()) / totalSeconds : 0.0},
+        {"cpuMs", summarize(std::move(cpu))},
+        {"gpuMs", summarize(std::move(gpu))},
+        {"perFrame", std::move(frames)},
+    };
+
+    std::ofstream out(options.report);
+    if (!out) {
+        std::cerr << std::format("Failed to open report file {}", options.report.string()) << std::endl;
+        std::exit(-1);
+    }
+    out << report.dump(2) << '\n';
+}
+
+}  // namespace headless
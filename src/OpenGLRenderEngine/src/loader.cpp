@@ -0,0 +1,162 @@
+#include "loader.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+namespace {
+
+const char* stateName(Loader::State state) {
+    switch (state) {
+    case Loader::State::Queued:
+        return "queued";
+    case Loader::State::Running:
+        return "loading";
+    case Loader::State::Uploading:
+        return "uploading";
+    case Loader::State::Done:
+        return "done";
+    case Loader::State::Failed:
+        return "failed";
+    }
+    return "";
+}
+
+}  // namespace
+
+Loader::Loader(GLFWwindow* share) {
+    // Window creation has to happen on the main thread; only the context is
+    // handed to the worker.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    context_ = glfwCreateWindow(1, 1, "RenderEngine Loader", nullptr, share);
+    if (context_ == nullptr) {
+        std::cerr << "Failed to create loader context" << std::endl;
+        std::exit(-1);
+    }
+    thread_ = std::thread([this] {
+        run();
+    });
+}
+
+Loader::~Loader() {
+    // jobs still queued are skipped; only the one running is waited for
+    stopping_.store(true, std::memory_order_relaxed);
+    requests_.push(Request{});
+    thread_.join();
+    glfwDestroyWindow(context_);
+
+    Completion completion;
+    while (completions_.tryPop(completion)) {
+        pending_.push_back(std::move(completion));
+    }
+    // the objects are shared, so the render context can free them
+    for (auto& pending : pending_) {
+        glDeleteSync(pending.fence);
+        if (pending.status->discard) {
+            pending.status->discard();
+        }
+    }
+}
+
+void Loader::submit(std::string name, Job job) {
+    auto status = std::make_shared<Status>();
+    status->name = std::move(name);
+    statuses_.push_back(status);
+    requests_.push(Request{std::move(status), std::move(job)});
+}
+
+void Loader::run() {
+    glfwMakeContextCurrent(context_);
+    for (;;) {
+        Request request = requests_.pop();
+        if (request.job == nullptr) {
+            break;
+        }
+        if (stopping_.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        Status& status = *request.status;
+        status.state.store(State::Running, std::memory_order_relaxed);
+        Completion completion{std::move(request.status), {}, {}};
+        bool failed = true;
+        try {
+            completion.ready = request.job(status);
+            failed = false;
+        } catch (const std::exception& e) {
+            std::cerr << "Loading " << status.name << " failed: " << e.what() << std::endl;
+        } catch (...) {
+            // anything escaping the thread function would call std::terminate
+            std::cerr << "Loading " << status.name << " failed: unknown exception" << std::endl;
+        }
+        if (failed) {
+            if (status.discard) {
+                status.discard();
+                status.discard = nullptr;
+            }
+            status.state.store(State::Failed, std::memory_order_relaxed);
+            // wake the render thread so the failure shows without other input
+            glfwPostEmptyEvent();
+            continue;
+        }
+        status.report(1.0f);
+        status.state.store(State::Uploading, std::memory_order_relaxed);
+
+        completion.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // Without a flush the fence may never reach the GPU from this context.
+        glFlush();
+        completions_.push(std::move(completion));
+        glfwPostEmptyEvent();
+    }
+    glfwMakeContextCurrent(nullptr);
+}
+
+bool Loader::poll() {
+    Completion completion;
+    while (completions_.tryPop(completion)) {
+        pending_.push_back(std::move(completion));
+    }
+
+    return std::erase_if(pending_, [](Completion& pending) {
+        const GLenum status = glClientWaitSync(pending.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return false;
+        }
+        glDeleteSync(pending.fence);
+        if (pending.ready) {
+            pending.ready();
+        }
+        pending.status->discard = nullptr;
+        pending.status->state.store(State::Done, std::memory_order_relaxed);
+        return true;
+    }) != 0;
+}
+
+void Loader::waitIdle() {
+    while (!idle()) {
+        poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool Loader::idle() const {
+    return std::ranges::all_of(statuses_, [](const auto& status) {
+        const State state = status->state.load(std::memory_order_relaxed);
+        return state == State::Done || state == State::Failed;
+    });
+}
+
+void Loader::drawUi() {
+    ImGui::Begin("Loader");
+    if (statuses_.empty()) {
+        ImGui::TextUnformatted("Nothing loaded");
+    }
+    for (const auto& status : statuses_) {
+        ImGui::Text("%s (%s)", status->name.c_str(), stateName(status->state.load(std::memory_order_relaxed)));
+        ImGui::ProgressBar(status->progress.load(std::memory_order_relaxed));
+    }
+    ImGui::End();
+}
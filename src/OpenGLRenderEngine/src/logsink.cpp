@@ -0,0 +1,124 @@
+#include "logsink.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return x;
+}
+
+}  // namespace
+
+LogSink::LogSink(std::shared_ptr<spdlog::logger> logger, Options options)
+    : logger_(std::move(logger)),
+      level_(options.level),
+      burst_(std::max(options.burst, 1)),
+      windowNs_(std::chrono::duration_cast<std::chrono::nanoseconds>(options.window).count()),
+      table_(std::make_unique<Entry[]>(tableSize)),
+      queue_(options.capacity) {
+    writer_ = std::thread([this] {
+        run();
+    });
+}
+
+LogSink::~LogSink() {
+    Record stop;
+    stop.stop = true;
+    queue_.push(std::move(stop));
+    writer_.join();
+
+    for (std::size_t i = 0; i < tableSize; ++i) {
+        if (const auto n = table_[i].suppressed.load(std::memory_order_relaxed); n != 0) {
+            logger_->info("{} repeats of message {:#x} suppressed", n, table_[i].id.load(std::memory_order_relaxed));
+        }
+    }
+    logger_->flush();
+}
+
+LogSink::Entry* LogSink::entryFor(std::uint64_t id) {
+    for (std::size_t i = 0, slot = mix(id) % tableSize; i < maxProbe; ++i, slot = (slot + 1) % tableSize) {
+        Entry& entry = table_[slot];
+        std::uint64_t seen = entry.id.load(std::memory_order_acquire);
+        if (seen == 0 && entry.id.compare_exchange_strong(seen, id, std::memory_order_acq_rel)) {
+            return &entry;
+        }
+        if (seen == id) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void LogSink::log(Level level, std::uint64_t id, std::string_view message) {
+    if (!enabled(level)) {
+        return;
+    }
+    std::uint32_t suppressed = 0;
+    // 0 also marks a free table entry
+    if (Entry* entry = id == 0 ? nullptr : entryFor(id)) {
+        const std::int64_t now = nowNs();
+        std::int64_t start = entry->windowStart.load(std::memory_order_relaxed);
+        if (now - start >= windowNs_ && entry->windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            // first message of a new window reports what the last one swallowed
+            entry->count.store(1, std::memory_order_relaxed);
+            suppressed = entry->suppressed.exchange(0, std::memory_order_relaxed);
+        } else if (entry->count.fetch_add(1, std::memory_order_relaxed) >= static_cast<std::uint32_t>(burst_)) {
+            entry->suppressed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    Record record;
+    record.level = level;
+    record.suppressed = suppressed;
+    if (message.size() <= maxMessage) {
+        record.length = static_cast<std::uint32_t>(message.size());
+        std::memcpy(record.text.data(), message.data(), message.size());
+    } else {
+        // cut before a UTF-8 lead byte so the ellipsis never splits a character
+        constexpr std::string_view ellipsis = "\xE2\x80\xA6";  // U+2026
+        std::size_t keep = maxMessage - ellipsis.size();
+        while (keep > 0 && (static_cast<unsigned char>(message[keep]) & 0xC0) == 0x80) {
+            --keep;
+        }
+        std::memcpy(record.text.data(), message.data(), keep);
+        std::memcpy(record.text.data() + keep, ellipsis.data(), ellipsis.size());
+        record.length = static_cast<std::uint32_t>(keep + ellipsis.size());
+    }
+    if (!queue_.tryPush(std::move(record))) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void LogSink::run() {
+    for (;;) {
+        const Record record = queue_.pop();
+        if (record.stop) {
+            break;
+        }
+
+        const std::string_view text(record.text.data(), record.length);
+        if (record.suppressed != 0) {
+            logger_->log(record.level, "{} (+{} repeats suppressed)", text, record.suppressed);
+        } else {
+            logger_->log(record.level, "{}", text);
+        }
+
+        if (queue_.sizeApprox() == 0) {
+            if (const auto dropped = dropped_.exchange(0, std::memory_order_relaxed); dropped != 0) {
+                logger_->warn("log queue full, {} messages dropped", dropped);
+            }
+            logger_->flush();
+        }
+    }
+}
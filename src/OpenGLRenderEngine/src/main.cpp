@@ -8,17 +8,57 @@
 #include <implot.h>
 #include <implot_internal.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <format>
-#include <thread>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gputimer.hpp"
+#include "headless.hpp"
+#include "loader.hpp"
+#include "logsink.hpp"
+#include "pointcloud.hpp"
+#include "profiler.hpp"
+#include "scheduler.hpp"
+#include "telemetry.hpp"
+
+#include "scl/timer.hpp"
 
 namespace glfw {
 
-GLFWwindow* init() {
+GLFWwindow* createHeadlessWindow(const headless::Options& options) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    // Prefer a surfaceless EGL context and fall back to OSMesa, so Mesa's
+    // llvmpipe works on build boxes without a GPU or display server.
+    for (int api : {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API}) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+        for (int minor : {6, 5}) {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+            if (GLFWwindow* window = glfwCreateWindow(options.width, options.height, "RenderEngine", nullptr, nullptr)) {
+                return window;
+            }
+        }
+    }
+    return nullptr;
+}
+
+GLFWwindow* init(const headless::Options& options) {
     glfwSetErrorCallback([](int error, const char* description) {
         std::cerr << std::format("GLFW Error {}: {}", error, description) << std::endl;
     });
 
+#ifdef GLFW_PLATFORM_NULL
+    if (options.enabled) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+#endif
     if (!glfwInit()) {
         std::exit(-1);
     }
@@ -27,7 +67,9 @@ GLFWwindow* init() {
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "RenderEngine", nullptr, nullptr);
+    GLFWwindow* window = options.enabled
+        ? createHeadlessWindow(options)
+        : glfwCreateWindow(1280, 720, "RenderEngine", nullptr, nullptr);
     if (window == nullptr) {
         std::exit(-1);
     }
@@ -35,7 +77,7 @@ GLFWwindow* init() {
     glfwSetFramebufferSizeCallback(window, []([[maybe_unused]] GLFWwindow* window, int width, int height) {
         glViewport(0, 0, width, height);
     });
-    glfwSwapInterval(1);
+    glfwSwapInterval(options.enabled ? 0 : 1);
 
     return window;
 }
@@ -44,24 +86,42 @@ GLFWwindow* init() {
 
 namespace opengl {
 
-void init() {
+LogSink::Level debugLevel(GLenum severity) {
+    switch (severity) {
+    case GL_DEBUG_SEVERITY_HIGH:
+        return LogSink::Level::err;
+    case GL_DEBUG_SEVERITY_MEDIUM:
+        return LogSink::Level::warn;
+    case GL_DEBUG_SEVERITY_LOW:
+        return LogSink::Level::info;
+    default:
+        return LogSink::Level::debug;
+    }
+}
+
+void init(LogSink& log) {
     if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
         std::cerr << "Failed to initialize GLAD" << std::endl;
         std::exit(-1);
     }
 
     glEnable(GL_DEBUG_OUTPUT);
+    // May fire on a driver thread and in bursts; LogSink drops repeats and
+    // never blocks the caller.
     glDebugMessageCallback([](
-        [[maybe_unused]] GLenum source,
-        [[maybe_unused]] GLenum type,
-        [[maybe_unused]] GLuint id,
-        [[maybe_unused]] GLenum severity,
-        [[maybe_unused]] GLsizei length,
+        GLenum source,
+        GLenum type,
+        GLuint id,
+        GLenum severity,
+        GLsizei length,
         const GLchar* message,
-        [[maybe_unused]] const void* userParam
+        const void* userParam
     ) {
-        std::cerr << "OpenGL Debug: " << message << std::endl;
-    }, nullptr);
+        auto& sink = *static_cast<LogSink*>(const_cast<void*>(userParam));
+        const auto key = static_cast<std::uint64_t>(source) << 48 ^ static_cast<std::uint64_t>(type) << 32 ^ id;
+        const auto text = length >= 0 ? std::string_view(message, static_cast<std::size_t>(length)) : std::string_view(message);
+        sink.log(debugLevel(severity), key, text);
+    }, &log);
 }
 
 }  // namespace opengl
@@ -78,8 +138,13 @@ void init(GLFWwindow* window) {
 
     ImGui::StyleColorsDark();
 
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    const std::string glsl = std::format("#version {}{}0", major, minor);
+
     ImGui_ImplGlfw_InitForOpenGL(window, true);
-    if (!ImGui_ImplOpenGL3_Init("#version 460")) {
+    if (!ImGui_ImplOpenGL3_Init(glsl.c_str())) {
         std::cerr << "Failed to initialize ImGui OpenGL3" << std::endl;
         std::exit(-1);
     }
@@ -125,37 +190,242 @@ void processInput(GLFWwindow* window) {
     }
 }
 
-int main() {
-    auto window = glfw::init();
-    opengl::init();
-    imgui::init(window);
+// Everything drawn each frame besides the profiler. Datasets come in through
+// the loader, so the first frames render while they are still being built.
+struct Scene {
+    // the size the telemetry view is meant for; the series keeps ~460 MB
+    static constexpr std::size_t telemetrySamples = 100'000'000;
+
+    TelemetryView telemetry;
+    PointCloudDemo pointCloud;
+    GLuint heightmap{};
+
+    explicit Scene(Loader& loader) {
+        loader.submit("telemetry series", [this](Loader::Status& status) -> std::function<void()> {
+            auto series = std::make_shared<TelemetrySeries>(makeSyntheticSeries(telemetrySamples, [&](float progress) {
+                status.report(progress);
+            }));
+            return [this, series] {
+                telemetry.setSeries(std::make_unique<TelemetrySeries>(std::move(*series)));
+            };
+        });
+        loader.submit("heightmap", [this](Loader::Status& status) -> std::function<void()> {
+            constexpr int size = 4096;
+            constexpr int strip = 256;
+            GLuint texture = 0;
+            glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+            status.discard = [texture] {
+                glDeleteTextures(1, &texture);
+            };
+            glTextureStorage2D(texture, 1, GL_RGBA8, size, size);
+            glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+            // decoded and uploaded a strip at a time, Jet-shaded like the point cloud
+            std::vector<std::uint32_t> pixels(static_cast<std::size_t>(size) * strip);
+            for (int y0 = 0; y0 < size; y0 += strip) {
+                for (int y = 0; y < strip; ++y) {
+                    for (int x = 0; x < size; ++x) {
+                        const float u = static_cast<float>(x) / size;
+                        const float v = static_cast<float>(y0 + y) / size;
+                        const float h = 0.5f + 0.25f * (std::sin(23.0f * u) * std::cos(17.0f * v) + std::sin(61.0f * u * v));
+                        auto channel = [&](float offset) {
+                            return static_cast<std::uint32_t>(255.0f * std::clamp(1.5f - std::abs(4.0f * h - offset), 0.0f, 1.0f));
+                        };
+                        pixels[static_cast<std::size_t>(y) * size + x] = channel(3.0f) | channel(2.0f) << 8 | channel(1.0f) << 16 | 0xFF000000u;
+                    }
+                }
+                glTextureSubImage2D(texture, 0, 0, y0, size, strip, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+                status.report(static_cast<float>(y0 + strip) / size);
+            }
+            return [this, texture] {
+                heightmap = texture;
+            };
+        });
+    }
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
 
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
-        if (glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            continue;
-        }
+    ~Scene() {
+        glDeleteTextures(1, &heightmap);
+    }
 
-        ImGuiIO& io = ImGui::GetIO();
-        if (!io.WantCaptureKeyboard && !io.WantCaptureMouse) {
-            processInput(window);
+    void drawHeightmap() const {
+        ImGui::Begin("Heightmap");
+        if (heightmap == 0) {
+            ImGui::TextUnformatted("Loading...");
+        } else {
+            const ImVec2 avail = ImGui::GetContentRegionAvail();
+            const float side = std::max(1.0f, std::min(avail.x, avail.y));
+            ImGui::Image((ImTextureID)(intptr_t)heightmap, ImVec2(side, side));
         }
+        ImGui::End();
+    }
+};
+
+void drawFrame(FrameProfiler& profiler, Scene& scene, Loader& loader, FrameScheduler* scheduler) {
+    using Phase = FrameProfiler::Phase;
 
+    {
+        auto scope = profiler.scope(Phase::Clear);
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
+    }
 
+    {
+        auto scope = profiler.scope(Phase::Scene);
+        scene.pointCloud.render();
+    }
+
+    {
+        auto scope = profiler.scope(Phase::ImGuiBuild);
         imgui::renderLoopBegin();
 
         imgui::fps();
         imgui::colorBar();
+        profiler.draw();
+        scene.telemetry.draw();
+        scene.pointCloud.drawUi();
+        scene.drawHeightmap();
+        loader.drawUi();
+        if (scheduler != nullptr) {
+            scheduler->drawUi();
+        }
+    }
 
+    {
+        auto scope = profiler.scope(Phase::Render);
         imgui::renderLoopEnd();
+    }
+}
 
-        glfwSwapBuffers(window);
+void runHeadless(GLFWwindow* window, const headless::Options& options, LogSink& log) {
+    using Clock = std::chrono::steady_clock;
+
+    headless::Framebuffer framebuffer(options.width, options.height);
+    // whole-frame GPU timing below; GL_TIME_ELAPSED queries cannot nest
+    FrameProfiler profiler(false);
+    Loader loader(window);
+    Scene scene(loader);
+    {
+        // benchmark the steady state, not the loading
+        scl::Timer timer("headless", [&](std::string_view line) {
+            log.log(LogSink::Level::info, line);
+        });
+        loader.waitIdle();
+        timer.timeStamp("loaded");
     }
+    constexpr double frameTime = 1.0 / 60.0;
+    GpuTimer gpuTimer;
+    std::vector<headless::FrameSample> samples(options.frames);
+    std::vector<double> gpuMs;
+    gpuMs.reserve(samples.size());
+
+    const auto start = Clock::now();
+    for (auto& sample : samples) {
+        const auto frameStart = Clock::now();
+        profiler.beginFrame();
+        {
+            auto scope = profiler.scope(FrameProfiler::Phase::Poll);
+            glfwPollEvents();
+        }
+        {
+            auto scope = profiler.scope(FrameProfiler::Phase::Loader);
+            loader.poll();
+        }
+        scene.pointCloud.advance(frameTime);
+        framebuffer.bind();
+
+        gpuTimer.begin();
+        drawFrame(profiler, scene, loader, nullptr);
+        gpuTimer.end();
+        gpuTimer.collect(gpuMs);
+        profiler.endFrame();
 
-    imgui::destroy();
+        sample.cpuMs = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+    }
+    glFinish();
+    const double totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    gpuTimer.collect(gpuMs, true);
+    for (std::size_t i = 0; i < samples.size() && i < gpuMs.size(); ++i) {
+        samples[i].gpuMs = gpuMs[i];
+    }
+    headless::writeReport(options, samples, totalSeconds);
+}
+
+void runWindowed(GLFWwindow* window, FrameScheduler& scheduler) {
+    using Phase = FrameProfiler::Phase;
+    FrameProfiler profiler;
+    Loader loader(window);
+    Scene scene(loader);
+    // the animation advances at a fixed rate however often frames are drawn
+    FixedTicker ticker(std::chrono::microseconds(8333), [&](double dt) {
+        if (scene.pointCloud.advance(dt)) {
+            scheduler.requestRedraw(1);
+        }
+    });
+
+    for (;;) {
+        scheduler.waitForFrame();
+        if (glfwWindowShouldClose(window)) {
+            break;
+        }
+
+        profiler.beginFrame();
+        {
+            auto scope = profiler.scope(Phase::Poll);
+            glfwPollEvents();
+        }
+
+        {
+            auto scope = profiler.scope(Phase::Loader);
+            // keep progress bars moving while anything is loading
+            if (loader.poll() || !loader.idle()) {
+                scheduler.requestRedraw();
+            }
+        }
+
+        {
+            auto scope = profiler.scope(Phase::Input);
+            ImGuiIO& io = ImGui::GetIO();
+            if (!io.WantCaptureKeyboard && !io.WantCaptureMouse) {
+                processInput(window);
+            }
+        }
+
+        drawFrame(profiler, scene, loader, &scheduler);
+
+        {
+            auto scope = profiler.scope(Phase::Swap);
+            glfwSwapBuffers(window);
+        }
+        profiler.endFrame();
+    }
+}
+
+int main(int argc, char** argv) {
+    const auto options = headless::parseArgs(argc, argv);
+    // outlives the GL context, whose debug callback writes to it
+    LogSink log(spdlog::default_logger());
+    auto window = glfw::init(options);
+    opengl::init(log);
+    {
+        // before imgui::init, so the ImGui backend chains its callbacks
+        FrameScheduler scheduler(window);
+        imgui::init(window);
+
+        if (options.enabled) {
+            runHeadless(window, options, log);
+        } else {
+            runWindowed(window, scheduler);
+        }
+
+        // hands the callbacks back to the scheduler, which must let go of
+        // the window before it is destroyed
+        imgui::destroy();
+    }
 
     glfwDestroyWindow(window);
     glfwTerminate();
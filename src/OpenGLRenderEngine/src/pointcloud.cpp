@@ -0,0 +1,254 @@
+#include "pointcloud.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "scl/threadpool.hpp"
+
+namespace {
+
+constexpr const char* vertexSource = R"(#version 450 core
+layout(location = 0) in vec4 point;
+uniform mat4 mvp;
+uniform float pointSize;
+out float value;
+void main() {
+    gl_Position = mvp * vec4(point.xyz, 1.0);
+    gl_PointSize = pointSize;
+    value = point.w;
+}
+)";
+
+// Piecewise-linear Jet, close to ImPlotColormap_Jet used by the color bar.
+constexpr const char* fragmentSource = R"(#version 450 core
+in float value;
+out vec4 color;
+vec3 jet(float t) {
+    return clamp(vec3(1.5) - abs(4.0 * t - vec3(3.0, 2.0, 1.0)), 0.0, 1.0);
+}
+void main() {
+    color = vec4(jet(clamp(value, 0.0, 1.0)), 1.0);
+}
+)";
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (ok == GL_FALSE) {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+        glGetShaderInfoLog(shader, length, nullptr, log.data());
+        std::cerr << "Failed to compile shader: " << log << std::endl;
+        std::exit(-1);
+    }
+    return shader;
+}
+
+GLuint linkProgram(const char* vertex, const char* fragment) {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, vertex);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, fragment);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (ok == GL_FALSE) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+        glGetProgramInfoLog(program, length, nullptr, log.data());
+        std::cerr << "Failed to link program: " << log << std::endl;
+        std::exit(-1);
+    }
+    return program;
+}
+
+// perspective(fovy, aspect) * view, where the camera orbits the origin at
+// `yaw` radians and looks slightly down.
+std::array<float, 16> orbitCamera(float yaw, float aspect) {
+    constexpr float fovy = 0.8f, near = 0.1f, far = 10.0f, distance = 3.2f, pitch = 0.5f;
+    const float f = 1.0f / std::tan(fovy * 0.5f);
+
+    const float cy = std::cos(yaw), sy = std::sin(yaw), cp = std::cos(pitch), sp = std::sin(pitch);
+    // view = translate(0, 0, -distance) * rotateX(pitch) * rotateZ(yaw), z up
+    const float view[16] = {
+        cy, sy * sp, -sy * cp, 0.0f,
+        -sy, cy * sp, -cy * cp, 0.0f,
+        0.0f, cp, sp, 0.0f,
+        0.0f, 0.0f, -distance, 1.0f,
+    };
+    const float proj[16] = {
+        f / aspect, 0.0f, 0.0f, 0.0f,
+        0.0f, f, 0.0f, 0.0f,
+        0.0f, 0.0f, (far + near) / (near - far), -1.0f,
+        0.0f, 0.0f, 2.0f * far * near / (near - far), 0.0f,
+    };
+
+    std::array<float, 16> mvp{};
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            for (int k = 0; k < 4; ++k) {
+                mvp[c * 4 + r] += proj[k * 4 + r] * view[c * 4 + k];
+            }
+        }
+    }
+    return mvp;
+}
+
+}  // namespace
+
+PointCloudRenderer::PointCloudRenderer(std::size_t maxPoints, std::size_t maxBatches)
+    : vertices_(static_cast<GLsizeiptr>(maxPoints * sizeof(PointVertex))),
+      commands_(static_cast<GLsizeiptr>(maxBatches * sizeof(DrawArraysIndirectCommand))),
+      program_(linkProgram(vertexSource, fragmentSource)) {
+    mvpLocation_ = glGetUniformLocation(program_, "mvp");
+    pointSizeLocation_ = glGetUniformLocation(program_, "pointSize");
+
+    // The VAO sees the whole ring; each frame's slice is selected through
+    // the `first` of its indirect commands, so nothing is rebound per frame.
+    glCreateVertexArrays(1, &vao_);
+    glVertexArrayVertexBuffer(vao_, 0, vertices_.buffer(), 0, sizeof(PointVertex));
+    glEnableVertexArrayAttrib(vao_, 0);
+    glVertexArrayAttribFormat(vao_, 0, 4, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(vao_, 0, 0);
+}
+
+PointCloudRenderer::~PointCloudRenderer() {
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteProgram(program_);
+}
+
+std::span<PointVertex> PointCloudRenderer::begin() {
+    batches_ = commands_.acquireAs<DrawArraysIndirectCommand>();
+    batchCount_ = 0;
+    const auto points = vertices_.acquireAs<PointVertex>();
+    baseVertex_ = static_cast<GLuint>(vertices_.offset() / static_cast<GLintptr>(sizeof(PointVertex)));
+    return points;
+}
+
+void PointCloudRenderer::addBatch(std::size_t first, std::size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (batchCount_ == batches_.size()) {
+        assert(batchCount_ != 0);
+        DrawArraysIndirectCommand& last = batches_[batchCount_ - 1];
+        assert(last.first + last.count == baseVertex_ + first);
+        last.count += static_cast<GLuint>(count);
+        return;
+    }
+    batches_[batchCount_++] = {
+        static_cast<GLuint>(count), 1, baseVertex_ + static_cast<GLuint>(first), 0,
+    };
+}
+
+void PointCloudRenderer::draw(const std::array<float, 16>& mvp, float pointSize) {
+    if (batchCount_ != 0) {
+        glUseProgram(program_);
+        glUniformMatrix4fv(mvpLocation_, 1, GL_FALSE, mvp.data());
+        glUniform1f(pointSizeLocation_, pointSize);
+        glEnable(GL_PROGRAM_POINT_SIZE);
+
+        glBindVertexArray(vao_);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_.buffer());
+        glMultiDrawArraysIndirect(GL_POINTS, reinterpret_cast<const void*>(commands_.offset()),
+                                  static_cast<GLsizei>(batchCount_), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+    vertices_.release();
+    commands_.release();
+}
+
+PointCloudDemo::PointCloudDemo(int maxSide)
+    : renderer_(static_cast<std::size_t>(maxSide) * maxSide), maxSide_(maxSide), side_(maxSide / 2) {}
+
+bool PointCloudDemo::advance(double dt) {
+    if (!animating_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    time_.store(time_.load(std::memory_order_relaxed) + static_cast<float>(dt), std::memory_order_relaxed);
+    return true;
+}
+
+void PointCloudDemo::render() {
+    const auto fillStart = Clock::now();
+    if (!enabled_) {
+        windowStart_ = fillStart;
+        windowPoints_ = 0.0;
+        pointsPerSecond_ = 0.0;
+        return;
+    }
+    const float t = time_.load(std::memory_order_relaxed);
+
+    // Ctrl+Click lets the sliders take any value
+    const int side = std::clamp(side_, 2, maxSide_);
+    const int strips = std::clamp(strips_, 1, side);
+    std::span<PointVertex> points = renderer_.begin();
+    assert(static_cast<std::size_t>(side) * side <= points.size());
+    const float step = 2.0f / static_cast<float>(side - 1);
+    scl::parallelFor(0, side, 16, [&](int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            const float y = -1.0f + step * static_cast<float>(i);
+            PointVertex* row = points.data() + static_cast<std::size_t>(i) * side;
+            for (int j = 0; j < side; ++j) {
+                const float x = -1.0f + step * static_cast<float>(j);
+                const float r = std::sqrt(x * x + y * y);
+                const float z = 0.25f * std::sin(10.0f * r - 3.0f * t) * std::exp(-1.5f * r);
+                row[j] = {x, y, z, 0.5f + 2.0f * z};
+            }
+        }
+    });
+    fillMs_ = std::chrono::duration<double, std::milli>(Clock::now() - fillStart).count();
+
+    // one indirect command per strip of rows
+    const int rowsPerStrip = (side + strips - 1) / strips;
+    for (int row = 0; row < side; row += rowsPerStrip) {
+        const int rows = std::min(rowsPerStrip, side - row);
+        renderer_.addBatch(static_cast<std::size_t>(row) * side, static_cast<std::size_t>(rows) * side);
+    }
+
+    GLint viewport[4] = {};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const float aspect = viewport[3] > 0 ? static_cast<float>(viewport[2]) / static_cast<float>(viewport[3]) : 1.0f;
+    renderer_.draw(orbitCamera(0.3f * t, aspect), pointSize_);
+
+    windowPoints_ += static_cast<double>(side) * side;
+    const double elapsed = std::chrono::duration<double>(Clock::now() - windowStart_).count();
+    if (elapsed >= 0.5) {
+        pointsPerSecond_ = windowPoints_ / elapsed;
+        windowStart_ = Clock::now();
+        windowPoints_ = 0.0;
+    }
+}
+
+void PointCloudDemo::drawUi() {
+    ImGui::Begin("Point Cloud");
+    ImGui::Checkbox("Enabled", &enabled_);
+    ImGui::SameLine();
+    ImGui::Checkbox("Animate", &animate_);
+    animating_.store(enabled_ && animate_, std::memory_order_relaxed);
+    ImGui::SliderInt("Grid side", &side_, 2, maxSide_, "%d", ImGuiSliderFlags_AlwaysClamp);
+    ImGui::SliderInt("Strips", &strips_, 1, 64, "%d", ImGuiSliderFlags_AlwaysClamp);
+    ImGui::SliderFloat("Point size", &pointSize_, 1.0f, 8.0f);
+
+    const double points = static_cast<double>(side_) * side_;
+    ImGui::Text("%.2f M points/frame, %.1f M points/s", points * 1e-6, pointsPerSecond_ * 1e-6);
+    ImGui::Text("fill %.2f ms, fence wait %.3f ms", fillMs_, renderer_.stallMs());
+    ImGui::End();
+}
@@ -0,0 +1,128 @@
+#include "profiler.hpp"
+
+#include <imgui.h>
+#include <implot.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <span>
+
+namespace {
+
+constexpr std::array<const char*, FrameProfiler::phaseCount> phaseNames = {
+    "glfwPollEvents", "loader", "input", "clear", "scene", "ImGui build", "renderLoopEnd", "glfwSwapBuffers",
+};
+
+}  // namespace
+
+void FrameProfiler::Series::push(float value) {
+    values[next] = value;
+    next = (next + 1) % values.size();
+    filled = std::min(filled + 1, values.size());
+}
+
+void FrameProfiler::Series::ordered(std::vector<float>& out) const {
+    out.assign(values.begin() + static_cast<std::ptrdiff_t>(next), values.end());
+    out.insert(out.end(), values.begin(), values.begin() + static_cast<std::ptrdiff_t>(next));
+}
+
+FrameProfiler::FrameProfiler(bool gpuTiming, std::size_t history)
+    : gpuTiming_(gpuTiming), history_(std::max<std::size_t>(history, 2)) {
+    for (auto& series : cpu_) {
+        series.values.assign(history_, 0.0f);
+    }
+    for (auto& series : gpu_) {
+        series.values.assign(history_, 0.0f);
+    }
+    frame_.values.assign(history_, 0.0f);
+}
+
+bool FrameProfiler::isGpuPhase(Phase phase) {
+    return phase == Phase::Clear || phase == Phase::Scene || phase == Phase::Render;
+}
+
+void FrameProfiler::beginFrame() {
+    frameStart_ = Clock::now();
+    cpuFrame_.fill(0.0f);
+}
+
+void FrameProfiler::endFrame() {
+    frame_.push(std::chrono::duration<float, std::milli>(Clock::now() - frameStart_).count());
+    for (std::size_t i = 0; i < phaseCount; ++i) {
+        cpu_[i].push(cpuFrame_[i]);
+        if (gpuTiming_ && isGpuPhase(static_cast<Phase>(i))) {
+            gpuResults_.clear();
+            gpuTimers_[i].collect(gpuResults_);
+            for (double ms : gpuResults_) {
+                gpu_[i].push(static_cast<float>(ms));
+            }
+        }
+    }
+}
+
+void FrameProfiler::begin(Phase phase) {
+    const auto i = static_cast<std::size_t>(phase);
+    phaseStart_[i] = Clock::now();
+    if (gpuTiming_ && isGpuPhase(phase)) {
+        gpuTimers_[i].begin();
+    }
+}
+
+void FrameProfiler::end(Phase phase) {
+    const auto i = static_cast<std::size_t>(phase);
+    if (gpuTiming_ && isGpuPhase(phase)) {
+        gpuTimers_[i].end();
+    }
+    cpuFrame_[i] += std::chrono::duration<float, std::milli>(Clock::now() - phaseStart_[i]).count();
+}
+
+void FrameProfiler::draw() {
+    ImGui::Begin("Frame Profiler");
+
+    // stats over recorded frames only, not the zeros the window starts with
+    std::vector<float> frame;
+    frame_.ordered(frame);
+    const std::span<const float> recorded = std::span(frame).last(frame_.filled);
+    if (recorded.empty()) {
+        ImGui::TextUnformatted("no frames recorded yet");
+    } else {
+        const float last = recorded.back();
+        const float worst = *std::max_element(recorded.begin(), recorded.end());
+        const float mean = std::accumulate(recorded.begin(), recorded.end(), 0.0f) / static_cast<float>(recorded.size());
+        ImGui::Text("frame %.2f ms   mean %.2f ms   worst %.2f ms", last, mean, worst);
+    }
+
+    auto stacked = [&](const char* title, const std::array<Series, phaseCount>& series, bool gpuOnly) {
+        if (!ImPlot::BeginPlot(title, ImVec2(-1, 200))) {
+            return;
+        }
+        ImPlot::SetupAxes("frame", "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        std::vector<float> base(history_, 0.0f), top(history_), values;
+        std::vector<float> xs(history_);
+        std::iota(xs.begin(), xs.end(), 0.0f);
+        for (std::size_t i = 0; i < phaseCount; ++i) {
+            if (gpuOnly && !isGpuPhase(static_cast<Phase>(i))) {
+                continue;
+            }
+            series[i].ordered(values);
+            std::transform(base.begin(), base.end(), values.begin(), top.begin(), std::plus<>{});
+            ImPlot::PlotShaded(phaseNames[i], xs.data(), base.data(), top.data(), static_cast<int>(history_));
+            base.swap(top);
+        }
+        ImPlot::EndPlot();
+    };
+
+    stacked("CPU phases", cpu_, false);
+    if (gpuTiming_) {
+        stacked("GPU phases", gpu_, true);
+    }
+
+    if (ImPlot::BeginPlot("Frame time histogram", ImVec2(-1, 160))) {
+        ImPlot::SetupAxes("ms", "frames", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotHistogram("frame", recorded.data(), static_cast<int>(recorded.size()), 50);
+        ImPlot::EndPlot();
+    }
+
+    ImGui::End();
+}
@@ -0,0 +1,200 @@
+#include "scheduler.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+
+#include "scl/cacheline.hpp"
+
+namespace {
+
+// Typical scheduler/timer slack; waits end this early and spin the rest.
+constexpr auto spinWindow = std::chrono::microseconds(1500);
+
+}  // namespace
+
+void sleepUntilPrecise(std::chrono::steady_clock::time_point deadline) {
+    using Clock = std::chrono::steady_clock;
+    if (deadline - Clock::now() > spinWindow) {
+        std::this_thread::sleep_until(deadline - spinWindow);
+    }
+    while (Clock::now() < deadline) {
+        scl::cpuRelax();
+    }
+}
+
+FrameScheduler::FrameScheduler(GLFWwindow* window) : window_(window) {
+    glfwSetWindowUserPointer(window_, this);
+    installCallbacks();
+}
+
+FrameScheduler::~FrameScheduler() {
+    glfwSetFramebufferSizeCallback(window_, prevFramebufferSize_);
+    glfwSetWindowRefreshCallback(window_, prevRefresh_);
+    glfwSetWindowFocusCallback(window_, prevFocus_);
+    glfwSetWindowIconifyCallback(window_, prevIconify_);
+    glfwSetCursorPosCallback(window_, prevCursorPos_);
+    glfwSetMouseButtonCallback(window_, prevMouseButton_);
+    glfwSetScrollCallback(window_, prevScroll_);
+    glfwSetKeyCallback(window_, prevKey_);
+    glfwSetCharCallback(window_, prevChar_);
+    glfwSetWindowUserPointer(window_, nullptr);
+}
+
+FrameScheduler& FrameScheduler::from(GLFWwindow* window) {
+    return *static_cast<FrameScheduler*>(glfwGetWindowUserPointer(window));
+}
+
+void FrameScheduler::installCallbacks() {
+    // Each callback marks the frame dirty and forwards to whatever was
+    // installed before, e.g. the viewport update from glfw::init.
+    prevFramebufferSize_ = glfwSetFramebufferSizeCallback(window_, [](GLFWwindow* window, int width, int height) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevFramebufferSize_ != nullptr) {
+            self.prevFramebufferSize_(window, width, height);
+        }
+    });
+    prevRefresh_ = glfwSetWindowRefreshCallback(window_, [](GLFWwindow* window) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevRefresh_ != nullptr) {
+            self.prevRefresh_(window);
+        }
+    });
+    prevFocus_ = glfwSetWindowFocusCallback(window_, [](GLFWwindow* window, int focused) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevFocus_ != nullptr) {
+            self.prevFocus_(window, focused);
+        }
+    });
+    prevIconify_ = glfwSetWindowIconifyCallback(window_, [](GLFWwindow* window, int iconified) {
+        auto& self = from(window);
+        self.iconified_.store(iconified != 0, std::memory_order_relaxed);
+        self.requestRedraw();
+        if (self.prevIconify_ != nullptr) {
+            self.prevIconify_(window, iconified);
+        }
+    });
+    prevCursorPos_ = glfwSetCursorPosCallback(window_, [](GLFWwindow* window, double x, double y) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevCursorPos_ != nullptr) {
+            self.prevCursorPos_(window, x, y);
+        }
+    });
+    prevMouseButton_ = glfwSetMouseButtonCallback(window_, [](GLFWwindow* window, int button, int action, int mods) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevMouseButton_ != nullptr) {
+            self.prevMouseButton_(window, button, action, mods);
+        }
+    });
+    prevScroll_ = glfwSetScrollCallback(window_, [](GLFWwindow* window, double x, double y) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevScroll_ != nullptr) {
+            self.prevScroll_(window, x, y);
+        }
+    });
+    prevKey_ = glfwSetKeyCallback(window_, [](GLFWwindow* window, int key, int scancode, int action, int mods) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevKey_ != nullptr) {
+            self.prevKey_(window, key, scancode, action, mods);
+        }
+    });
+    prevChar_ = glfwSetCharCallback(window_, [](GLFWwindow* window, unsigned int codepoint) {
+        auto& self = from(window);
+        self.requestRedraw();
+        if (self.prevChar_ != nullptr) {
+            self.prevChar_(window, codepoint);
+        }
+    });
+}
+
+void FrameScheduler::requestRedraw(int frames) {
+    int pending = pending_.load(std::memory_order_relaxed);
+    while (pending < frames && !pending_.compare_exchange_weak(pending, frames, std::memory_order_relaxed)) {}
+    if (std::this_thread::get_id() != mainThread_ && !iconified_.load(std::memory_order_relaxed)) {
+        glfwPostEmptyEvent();
+    }
+}
+
+void FrameScheduler::setTargetFps(double fps) {
+    // a swap that blocks on vsync would round every period up to a refresh
+    glfwSwapInterval(fps > 0.0 ? 0 : 1);
+    targetFps_ = static_cast<float>(fps);
+    period_ = fps > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+        : Clock::duration::zero();
+}
+
+void FrameScheduler::waitForFrame() {
+    for (;;) {
+        if (glfwWindowShouldClose(window_)) {
+            return;
+        }
+        if (iconified_.load(std::memory_order_relaxed) || (!continuous_ && pending_.load(std::memory_order_relaxed) <= 0)) {
+            // nothing to draw: sleep until the OS or another thread has news
+            glfwWaitEvents();
+            ++wakeups_;
+            continue;
+        }
+
+        const auto now = Clock::now();
+        if (period_ == Clock::duration::zero() || now >= nextFrame_) {
+            break;
+        }
+        const auto remaining = nextFrame_ - now;
+        if (remaining > spinWindow) {
+            glfwWaitEventsTimeout(std::chrono::duration<double>(remaining - spinWindow).count());
+            continue;
+        }
+        sleepUntilPrecise(nextFrame_);
+        break;
+    }
+
+    // Never schedule in the past, so a stall does not turn into a burst.
+    nextFrame_ = std::max(nextFrame_ + period_, Clock::now());
+    if (pending_.load(std::memory_order_relaxed) > 0) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    ++framesDrawn_;
+}
+
+void FrameScheduler::drawUi() {
+    ImGui::Begin("Frame Scheduler");
+    ImGui::Checkbox("Continuous", &continuous_);
+    if (ImGui::SliderFloat("Target FPS", &targetFps_, 0.0f, 240.0f, targetFps_ > 0.0f ? "%.0f" : "vsync")) {
+        setTargetFps(targetFps_);
+    }
+    ImGui::Text("frames drawn %lld, idle wake-ups %lld", framesDrawn_, wakeups_);
+    ImGui::End();
+}
+
+FixedTicker::FixedTicker(std::chrono::nanoseconds period, std::function<void(double)> tick)
+    : period_(period), tick_(std::move(tick)) {
+    thread_ = std::thread([this] {
+        using Clock = std::chrono::steady_clock;
+        constexpr int maxCatchUp = 5;
+        const double dt = std::chrono::duration<double>(period_).count();
+
+        auto next = Clock::now() + period_;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            // a tick a millisecond late is harmless, so no spinning here
+            std::this_thread::sleep_until(next);
+            for (int i = 0; i < maxCatchUp && Clock::now() >= next; ++i) {
+                tick_(dt);
+                next += period_;
+            }
+            next = std::max(next, Clock::now());
+        }
+    });
+}
+
+FixedTicker::~FixedTicker() {
+    stop_.store(true, std::memory_order_relaxed);
+    thread_.join();
+}
@@ -0,0 +1,49 @@
+#include "streambuffer.hpp"
+
+#include <chrono>
+
+StreamBuffer::StreamBuffer(GLsizeiptr regionSize, int regions)
+    : regionSize_((regionSize + alignment - 1) / alignment * alignment), fences_(regions, nullptr) {
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = regionSize_ * regions;
+    glCreateBuffers(1, &buffer_);
+    glNamedBufferStorage(buffer_, size, nullptr, flags);
+    mapping_ = static_cast<std::byte*>(glMapNamedBufferRange(buffer_, 0, size, flags));
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync fence : fences_) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+    glUnmapNamedBuffer(buffer_);
+    glDeleteBuffers(1, &buffer_);
+}
+
+std::span<std::byte> StreamBuffer::acquire() {
+    using Clock = std::chrono::steady_clock;
+
+    current_ = (current_ + 1) % static_cast<int>(fences_.size());
+    stallMs_ = 0.0;
+    if (GLsync& fence = fences_[current_]; fence != nullptr) {
+        const auto start = Clock::now();
+        GLbitfield flags = 0;
+        for (;;) {
+            const GLenum status = glClientWaitSync(fence, flags, 1'000'000);
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED) {
+                break;
+            }
+            // make sure the fence actually reaches the GPU before waiting again
+            flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+        stallMs_ = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+    return {mapping_ + offset(), static_cast<std::size_t>(regionSize_)};
+}
+
+void StreamBuffer::release() {
+    fences_[current_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,68 @@
+#include "telemetry.hpp"
+
+#include <imgui.h>
+#include <implot.h>
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+TelemetrySeries makeSyntheticSeries(std::size_t n, const std::function<void(float)>& progress) {
+    // the RNG dominates; bucketing the samples is a single cheap pass
+    constexpr float generateShare = 0.9f;
+    std::mt19937 rng(20240601);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::uniform_real_distribution<float> spike(0.0f, 1.0f);
+
+    std::vector<float> ys(n);
+    float walk = 0.0f;
+    for (std::size_t i = 0; i < n; ++i) {
+        walk += noise(rng) * 0.1f;
+        // double, since a float time loses the 37x term well before 10^8 samples
+        const double t = static_cast<double>(i) * 1e-4;
+        ys[i] = walk + static_cast<float>(std::sin(t) + 0.2 * std::sin(37.0 * t)) + noise(rng);
+        if (spike(rng) < 1e-6f) {
+            ys[i] += 5.0f;
+        }
+        if (progress && i % (1 << 20) == 0) {
+            progress(generateShare * static_cast<float>(i) / static_cast<float>(n));
+        }
+    }
+    if (!progress) {
+        return TelemetrySeries(std::move(ys), 0.0, 1e-3);
+    }
+    return TelemetrySeries(std::move(ys), 0.0, 1e-3, [&](float built) {
+        progress(generateShare + (1.0f - generateShare) * built);
+    });
+}
+
+void TelemetryView::setSeries(std::unique_ptr<TelemetrySeries> series) {
+    series_ = std::move(series);
+}
+
+void TelemetryView::draw() {
+    ImGui::Begin("Telemetry");
+    if (series_ == nullptr) {
+        ImGui::TextUnformatted("No series loaded");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("%zu samples, %zu columns drawn", series_->size(), envelope_.x.size());
+    if (ImPlot::BeginPlot("##telemetry", ImVec2(-1, -1))) {
+        ImPlot::SetupAxes("t [s]", "value", ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisLimits(ImAxis_X1, series_->xBegin(), series_->xEnd(), ImPlotCond_Once);
+
+        const ImPlotRect limits = ImPlot::GetPlotLimits();
+        const int columns = static_cast<int>(ImPlot::GetPlotSize().x);
+        series_->decimate(limits.X.Min, limits.X.Max, columns, envelope_);
+
+        const int count = static_cast<int>(envelope_.x.size());
+        ImPlot::PlotShaded("range", envelope_.x.data(), envelope_.lo.data(), envelope_.hi.data(), count);
+        ImPlot::PlotLine("min", envelope_.x.data(), envelope_.lo.data(), count);
+        ImPlot::PlotLine("max", envelope_.x.data(), envelope_.hi.data(), count);
+        ImPlot::EndPlot();
+    }
+    ImGui::End();
+}
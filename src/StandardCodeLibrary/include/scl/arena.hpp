@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+namespace scl {
+
+// Bump allocator: deallocate is a no-op and everything is returned at once by
+// reset() or release(). After a reset the chunks are coalesced into one, so a
+// workload of steady size settles into a single chunk and reset() is O(1).
+class Arena final : public std::pmr::memory_resource {
+public:
+    explicit Arena(std::size_t chunkSize = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : chunkSize_(std::max<std::size_t>(chunkSize, 256)), upstream_(upstream) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() override {
+        release();
+    }
+
+    std::pmr::memory_resource* upstream() const noexcept {
+        return upstream_;
+    }
+
+    std::size_t bytesAllocated() const noexcept {
+        return used_ + static_cast<std::size_t>(cur_ - begin_);
+    }
+
+    std::size_t bytesReserved() const noexcept {
+        return reserved_;
+    }
+
+    void reset() {
+        if (head_ != nullptr && head_->next != nullptr) {
+            const std::size_t total = reserved_;
+            release();
+            pushChunk(total);
+        }
+        if (head_ != nullptr) {
+            begin_ = cur_ = head_->data();
+            end_ = begin_ + head_->size;
+        }
+        used_ = 0;
+    }
+
+    void release() noexcept {
+        while (head_ != nullptr) {
+            Chunk* next = head_->next;
+            upstream_->deallocate(head_, sizeof(Chunk) + head_->size, alignof(Chunk));
+            head_ = next;
+        }
+        begin_ = cur_ = end_ = nullptr;
+        used_ = reserved_ = 0;
+    }
+
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        std::size_t size;
+
+        std::byte* data() noexcept {
+            return reinterpret_cast<std::byte*>(this + 1);
+        }
+    };
+
+    void pushChunk(std::size_t size) {
+        void* raw = upstream_->allocate(sizeof(Chunk) + size, alignof(Chunk));
+        head_ = ::new (raw) Chunk{head_, size};
+        used_ += static_cast<std::size_t>(cur_ - begin_);
+        begin_ = cur_ = head_->data();
+        end_ = begin_ + size;
+        reserved_ += size;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        auto p = reinterpret_cast<std::uintptr_t>(cur_);
+        auto aligned = (p + alignment - 1) & ~(alignment - 1);
+        if (cur_ == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+            pushChunk(std::max({chunkSize_, reserved_, bytes + alignment}));
+            p = reinterpret_cast<std::uintptr_t>(cur_);
+            aligned = (p + alignment - 1) & ~(alignment - 1);
+        }
+        cur_ += aligned - p + bytes;
+        return cur_ - bytes;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t chunkSize_;
+    std::pmr::memory_resource* upstream_;
+    Chunk* head_{};
+    std::byte* begin_{};
+    std::byte* cur_{};
+    std::byte* end_{};
+    std::size_t used_{};
+    std::size_t reserved_{};
+};
+
+// Free lists for power-of-two size classes up to maxBlock bytes, carved out
+// of slabs from the upstream resource. Larger requests go straight upstream.
+// Not thread-safe; put one per thread or per request.
+class PoolResource final : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t minBlock = 16;
+    static constexpr std::size_t maxBlock = 4096;
+
+    explicit PoolResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(), std::size_t slabSize = 64 * 1024)
+        : slabSize_(std::max(slabSize, maxBlock)), upstream_(upstream) {}
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource() override {
+        release();
+    }
+
+    void release() noexcept {
+        while (slabs_ != nullptr) {
+            Node* next = slabs_->next;
+            upstream_->deallocate(slabs_, slabSize_, alignof(std::max_align_t));
+            slabs_ = next;
+        }
+        free_.fill(nullptr);
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    static constexpr std::size_t classCount = std::countr_zero(maxBlock) - std::countr_zero(minBlock) + 1;
+
+    static std::size_t classOf(std::size_t bytes) noexcept {
+        return static_cast<std::size_t>(std::bit_width(std::max(bytes, minBlock) - 1)) - std::countr_zero(minBlock);
+    }
+
+    void refill(std::size_t cls) {
+        auto* slab = static_cast<std::byte*>(upstream_->allocate(slabSize_, alignof(std::max_align_t)));
+        slabs_ = ::new (slab) Node{slabs_};
+
+        const std::size_t block = minBlock << cls;
+        for (std::size_t off = std::max(block, sizeof(Node)); off + block <= slabSize_; off += block) {
+            free_[cls] = ::new (slab + off) Node{free_[cls]};
+        }
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes > maxBlock || alignment > alignof(std::max_align_t)) {
+            return upstream_->allocate(bytes, alignment);
+        }
+        const std::size_t cls = classOf(bytes);
+        if (free_[cls] == nullptr) {
+            refill(cls);
+        }
+        Node* node = free_[cls];
+        free_[cls] = node->next;
+        return node;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (bytes > maxBlock || alignment > alignof(std::max_align_t)) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        const std::size_t cls = classOf(bytes);
+        free_[cls] = ::new (p) Node{free_[cls]};
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t slabSize_;
+    std::pmr::memory_resource* upstream_;
+    Node* slabs_{};
+    std::array<Node*, classCount> free_{};
+};
+
+}  // namespace scl
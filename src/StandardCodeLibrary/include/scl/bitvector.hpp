@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace scl {
+
+// Position of the k-th (0-based) set bit of x; x must have more than k.
+inline int selectInWord(std::uint64_t x, int k) {
+#if defined(__BMI2__)
+    return std::countr_zero(_pdep_u64(std::uint64_t{1} << k, x));
+#else
+    // broadword byte counts: byte j of `prefix` is popcount of bytes 0..j
+    std::uint64_t s = x - ((x >> 1) & 0x5555555555555555ull);
+    s = (s & 0x3333333333333333ull) + ((s >> 2) & 0x3333333333333333ull);
+    s = (s + (s >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    const std::uint64_t prefix = s * 0x0101010101010101ull;
+
+    int byte = 0;
+    while (static_cast<int>((prefix >> (8 * byte)) & 0xff) <= k) {
+        ++byte;
+    }
+    if (byte != 0) {
+        k -= static_cast<int>((prefix >> (8 * (byte - 1))) & 0xff);
+    }
+    std::uint32_t bits = static_cast<std::uint32_t>((x >> (8 * byte)) & 0xff);
+    for (; k > 0; --k) {
+        bits &= bits - 1;
+    }
+    return 8 * byte + std::countr_zero(bits);
+#endif
+}
+
+// Static bitvector with O(1) rank and near-O(1) select. Rank keeps an
+// absolute u64 count per 2^16 bits and a u16 count per 512 bits relative to
+// it, about 3.2% on top of the bits. Select samples the block holding every
+// 4096th one (and zero), binary searches the blocks between two samples and
+// finishes inside a word with selectInWord.
+// Usage: set bits, then build() once before any query.
+class BitVector {
+public:
+    static constexpr std::size_t blockBits = 512;
+    static constexpr std::size_t superBits = 1 << 16;
+    static constexpr std::size_t sampleRate = 4096;
+
+    BitVector() = default;
+
+    explicit BitVector(std::size_t n)
+        : n_(n), words_((n + blockBits - 1) / blockBits * (blockBits / 64), 0) {}
+
+    std::size_t size() const {
+        return n_;
+    }
+
+    void set(std::size_t i, bool value = true) {
+        assert(i < n_);
+        const std::uint64_t bit = std::uint64_t{1} << (i % 64);
+        if (value) {
+            words_[i / 64] |= bit;
+        } else {
+            words_[i / 64] &= ~bit;
+        }
+    }
+
+    // Bits [64 * w, 64 * w + 64) at once; bits past size() must be zero.
+    void setWord(std::size_t w, std::uint64_t bits) {
+        assert(w < (n_ + 63) / 64);
+        words_[w] = bits;
+    }
+
+    bool operator[](std::size_t i) const {
+        assert(i < n_);
+        return (words_[i / 64] >> (i % 64)) & 1;
+    }
+
+    void build() {
+        const std::size_t blocks = words_.size() / (blockBits / 64);
+        super_.assign(blocks / (superBits / blockBits) + 1, 0);
+        block_.assign(blocks + 1, 0);
+        sample1_.clear();
+        sample0_.clear();
+
+        std::uint64_t total = 0;
+        for (std::size_t b = 0; b <= blocks; ++b) {
+            if (b % (superBits / blockBits) == 0) {
+                super_[b / (superBits / blockBits)] = total;
+            }
+            block_[b] = static_cast<std::uint16_t>(total - super_[b / (superBits / blockBits)]);
+            if (b == blocks) {
+                break;
+            }
+
+            std::uint64_t count = 0;
+            for (std::size_t w = b * (blockBits / 64); w < (b + 1) * (blockBits / 64); ++w) {
+                count += std::popcount(words_[w]);
+            }
+            // record this block for every sampled one and zero it contains
+            while (sample1_.size() * sampleRate < total + count) {
+                sample1_.push_back(static_cast<std::uint32_t>(b));
+            }
+            const std::uint64_t zerosAfter = std::min<std::uint64_t>((b + 1) * blockBits, n_) - (total + count);
+            while (sample0_.size() * sampleRate < zerosAfter) {
+                sample0_.push_back(static_cast<std::uint32_t>(b));
+            }
+            total += count;
+        }
+        ones_ = total;
+    }
+
+    std::size_t ones() const {
+        return ones_;
+    }
+
+    std::size_t zeros() const {
+        return n_ - ones_;
+    }
+
+    // Ones in [0, i).
+    std::size_t rank1(std::size_t i) const {
+        assert(i <= n_);
+        std::size_t ans = blockRank(i / blockBits);
+        for (std::size_t w = i / blockBits * (blockBits / 64); w < i / 64; ++w) {
+            ans += std::popcount(words_[w]);
+        }
+        if (i % 64 != 0) {
+            ans += std::popcount(words_[i / 64] & ((std::uint64_t{1} << (i % 64)) - 1));
+        }
+        return ans;
+    }
+
+    // Zeros in [0, i).
+    std::size_t rank0(std::size_t i) const {
+        return i - rank1(i);
+    }
+
+    // Position of the k-th (0-based) one; k < ones().
+    std::size_t select1(std::size_t k) const {
+        assert(k < ones_);
+        return select<true>(k, sample1_);
+    }
+
+    // Position of the k-th (0-based) zero; k < zeros().
+    std::size_t select0(std::size_t k) const {
+        assert(k < zeros());
+        return select<false>(k, sample0_);
+    }
+
+    std::size_t bytes() const {
+        return words_.size() * sizeof(std::uint64_t) + super_.size() * sizeof(std::uint64_t)
+            + block_.size() * sizeof(std::uint16_t)
+            + (sample1_.size() + sample0_.size()) * sizeof(std::uint32_t);
+    }
+
+private:
+    std::size_t blockRank(std::size_t b) const {
+        return super_[b / (superBits / blockBits)] + block_[b];
+    }
+
+    template<bool One>
+    std::size_t countBefore(std::size_t b) const {
+        return One ? blockRank(b) : b * blockBits - blockRank(b);
+    }
+
+    template<bool One>
+    std::size_t select(std::size_t k, const std::vector<std::uint32_t>& samples) const {
+        const std::size_t s = k / sampleRate;
+        // last block whose count before it is <= k lies in [lo, hi)
+        std::size_t lo = samples[s];
+        std::size_t hi = s + 1 < samples.size() ? samples[s + 1] + 1 : block_.size() - 1;
+        while (hi - lo > 1) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (countBefore<One>(mid) <= k) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+
+        k -= countBefore<One>(lo);
+        for (std::size_t w = lo * (blockBits / 64);; ++w) {
+            const std::uint64_t word = One ? words_[w] : ~words_[w];
+            const auto count = static_cast<std::size_t>(std::popcount(word));
+            if (k < count) {
+                return w * 64 + selectInWord(word, static_cast<int>(k));
+            }
+            k -= count;
+        }
+    }
+
+    std::size_t n_{};
+    std::size_t ones_{};
+    std::vector<std::uint64_t> words_;
+    std::vector<std::uint64_t> super_;
+    std::vector<std::uint16_t> block_;
+    std::vector<std::uint32_t> sample1_;
+    std::vector<std::uint32_t> sample0_;
+};
+
+}  // namespace scl
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <span>
+#include <vector>
+
+namespace scl {
+
+// Point add, prefix sum. T needs +, - and a zero from T{}.
+template<class T>
+class Fenwick {
+public:
+    Fenwick() = default;
+
+    explicit Fenwick(int n) : a_(n, T{}) {}
+
+    // O(n): each node passes its total up to its parent once.
+    explicit Fenwick(std::span<const T> init) : a_(init.begin(), init.end()) {
+        const int n = size();
+        for (int i = 1; i <= n; ++i) {
+            const int parent = i + (i & -i);
+            if (parent <= n) {
+                a_[parent - 1] = a_[parent - 1] + a_[i - 1];
+            }
+        }
+    }
+
+    int size() const {
+        return static_cast<int>(a_.size());
+    }
+
+    void add(int p, const T& v) {
+        assert(0 <= p && p < size());
+        for (int i = p + 1; i <= size(); i += i & -i) {
+            a_[i - 1] = a_[i - 1] + v;
+        }
+    }
+
+    // [0, r)
+    T sum(int r) const {
+        assert(0 <= r && r <= size());
+        T ans{};
+        for (int i = r; i > 0; i -= i & -i) {
+            ans = ans + a_[i - 1];
+        }
+        return ans;
+    }
+
+    // [l, r)
+    T rangeSum(int l, int r) const {
+        return sum(r) - sum(l);
+    }
+
+    // Smallest r with sum(r + 1) >= k, or size() if there is none. Needs
+    // non-negative elements; one descent from the top bit, O(log n).
+    int lowerBound(T k) const {
+        const int n = size();
+        int pos = 0;
+        T cur{};
+        for (int step = n == 0 ? 0 : std::bit_floor(static_cast<unsigned>(n)); step > 0; step >>= 1) {
+            if (pos + step <= n && cur + a_[pos + step - 1] < k) {
+                pos += step;
+                cur = cur + a_[pos - 1];
+            }
+        }
+        return pos;
+    }
+
+private:
+    std::vector<T> a_;
+};
+
+// Range add, range sum, on two Fenwicks: sum(r) = r * B1(r) - B2(r).
+template<class T>
+class RangeFenwick {
+public:
+    RangeFenwick() = default;
+
+    explicit RangeFenwick(int n) : b1_(n), b2_(n) {}
+
+    int size() const {
+        return b1_.size();
+    }
+
+    // [l, r) += v
+    void add(int l, int r, const T& v) {
+        assert(0 <= l && l <= r && r <= size());
+        if (l < size()) {
+            b1_.add(l, v);
+            b2_.add(l, v * static_cast<T>(l));
+        }
+        if (r < size()) {
+            b1_.add(r, T{} - v);
+            b2_.add(r, T{} - v * static_cast<T>(r));
+        }
+    }
+
+    // [0, r)
+    T sum(int r) const {
+        return b1_.sum(r) * static_cast<T>(r) - b2_.sum(r);
+    }
+
+    // [l, r)
+    T rangeSum(int l, int r) const {
+        return sum(r) - sum(l);
+    }
+
+private:
+    Fenwick<T> b1_;
+    Fenwick<T> b2_;
+};
+
+}  // namespace scl
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace scl {
+
+// Unlike Flags<T>, the enumerators of E are bit indices in [0, N), not masks.
+// All word loops have a fixed trip count so the compiler vectorizes them.
+template<typename E, std::size_t N>
+requires std::is_enum_v<E> && (N > 0)
+class FlagSet {
+public:
+    using word_type = std::uint64_t;
+
+    static constexpr std::size_t wordBits = 64;
+    static constexpr std::size_t wordCount = (N + wordBits - 1) / wordBits;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = E;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = E;
+
+        constexpr iterator() noexcept = default;
+
+        constexpr E operator*() const noexcept {
+            return static_cast<E>(index_ * wordBits + std::countr_zero(word_));
+        }
+
+        constexpr iterator& operator++() noexcept {
+            word_ &= word_ - 1;
+            skipEmpty();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) noexcept {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        constexpr bool operator==(const iterator& other) const noexcept {
+            return index_ == other.index_ && word_ == other.word_;
+        }
+
+    private:
+        friend class FlagSet;
+
+        constexpr iterator(const FlagSet* set, std::size_t index) noexcept
+            : set_{set}, index_{index}, word_{index < wordCount ? set->words_[index] : 0} {
+            skipEmpty();
+        }
+
+        constexpr void skipEmpty() noexcept {
+            while (word_ == 0 && index_ < wordCount) {
+                if (++index_ < wordCount) {
+                    word_ = set_->words_[index_];
+                }
+            }
+        }
+
+        const FlagSet* set_{};
+        std::size_t index_{wordCount};
+        word_type word_{};
+    };
+
+    constexpr FlagSet() noexcept = default;
+
+    constexpr explicit FlagSet(E flag) noexcept {
+        set(flag);
+    }
+
+    constexpr FlagSet(std::initializer_list<E> flags) noexcept {
+        for (E flag : flags) {
+            set(flag);
+        }
+    }
+
+    constexpr FlagSet(FlagSet&&) noexcept = default;
+    constexpr FlagSet(const FlagSet&) noexcept = default;
+
+    constexpr FlagSet& operator=(const FlagSet&) noexcept = default;
+
+    static constexpr std::size_t size() noexcept {
+        return N;
+    }
+
+    constexpr const std::array<word_type, wordCount>& words() const noexcept {
+        return words_;
+    }
+
+    constexpr FlagSet& set(E flag) noexcept {
+        words_[wordOf(flag)] |= bitOf(flag);
+        return *this;
+    }
+
+    constexpr FlagSet& reset(E flag) noexcept {
+        words_[wordOf(flag)] &= ~bitOf(flag);
+        return *this;
+    }
+
+    constexpr FlagSet& flip(E flag) noexcept {
+        words_[wordOf(flag)] ^= bitOf(flag);
+        return *this;
+    }
+
+    constexpr bool contains(E flag) const noexcept {
+        return (words_[wordOf(flag)] & bitOf(flag)) != 0;
+    }
+
+    constexpr bool containsAll(const FlagSet& other) const noexcept {
+        word_type missing = 0;
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            missing |= other.words_[i] & ~words_[i];
+        }
+        return missing == 0;
+    }
+
+    constexpr bool intersects(const FlagSet& other) const noexcept {
+        word_type common = 0;
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            common |= words_[i] & other.words_[i];
+        }
+        return common != 0;
+    }
+
+    constexpr void reset() noexcept {
+        words_ = {};
+    }
+
+    constexpr bool any() const noexcept {
+        word_type acc = 0;
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            acc |= words_[i];
+        }
+        return acc != 0;
+    }
+
+    constexpr bool none() const noexcept {
+        return !any();
+    }
+
+    constexpr bool all() const noexcept {
+        return *this == ~FlagSet{};
+    }
+
+    constexpr std::size_t count() const noexcept {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            total += static_cast<std::size_t>(std::popcount(words_[i]));
+        }
+        return total;
+    }
+
+    constexpr iterator begin() const noexcept {
+        return iterator{this, 0};
+    }
+
+    constexpr iterator end() const noexcept {
+        return iterator{};
+    }
+
+    template<typename F>
+    constexpr void forEach(F&& f) const {
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            for (word_type w = words_[i]; w != 0; w &= w - 1) {
+                f(static_cast<E>(i * wordBits + std::countr_zero(w)));
+            }
+        }
+    }
+
+    constexpr FlagSet operator|(const FlagSet& o) const noexcept {
+        FlagSet res = *this;
+        return res |= o;
+    }
+
+    constexpr FlagSet operator&(const FlagSet& o) const noexcept {
+        FlagSet res = *this;
+        return res &= o;
+    }
+
+    constexpr FlagSet operator^(const FlagSet& o) const noexcept {
+        FlagSet res = *this;
+        return res ^= o;
+    }
+
+    constexpr FlagSet andNot(const FlagSet& o) const noexcept {
+        FlagSet res;
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            res.words_[i] = words_[i] & ~o.words_[i];
+        }
+        return res;
+    }
+
+    constexpr FlagSet operator~() const noexcept {
+        FlagSet res;
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            res.words_[i] = ~words_[i];
+        }
+        res.words_[wordCount - 1] &= lastWordMask;
+        return res;
+    }
+
+    constexpr FlagSet operator|(E o) const noexcept {
+        return FlagSet{*this}.set(o);
+    }
+
+    constexpr FlagSet operator&(E o) const noexcept {
+        return contains(o) ? FlagSet{o} : FlagSet{};
+    }
+
+    constexpr FlagSet operator^(E o) const noexcept {
+        return FlagSet{*this}.flip(o);
+    }
+
+    constexpr FlagSet& operator|=(const FlagSet& o) noexcept {
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            words_[i] |= o.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr FlagSet& operator&=(const FlagSet& o) noexcept {
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            words_[i] &= o.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr FlagSet& operator^=(const FlagSet& o) noexcept {
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            words_[i] ^= o.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr FlagSet& operator|=(E o) noexcept {
+        return set(o);
+    }
+
+    constexpr FlagSet& operator&=(E o) noexcept {
+        return *this = *this & o;
+    }
+
+    constexpr FlagSet& operator^=(E o) noexcept {
+        return flip(o);
+    }
+
+    constexpr bool operator==(const FlagSet& other) const noexcept = default;
+
+private:
+    static constexpr word_type lastWordMask = N % wordBits == 0
+        ? ~word_type{0}
+        : (word_type{1} << (N % wordBits)) - 1;
+
+    static constexpr std::size_t wordOf(E flag) noexcept {
+        assert(static_cast<std::size_t>(flag) < N);
+        return static_cast<std::size_t>(flag) / wordBits;
+    }
+
+    static constexpr word_type bitOf(E flag) noexcept {
+        return word_type{1} << (static_cast<std::size_t>(flag) % wordBits);
+    }
+
+    std::array<word_type, wordCount> words_{};
+};
+
+// Bulk operations over record arrays. The filters append matching indices to
+// `out`, so one buffer can be reused across batches without reallocating.
+// The element type is deduced from the mask, so vectors convert to spans.
+
+template<typename E, std::size_t N>
+void filterAll(std::span<const std::type_identity_t<FlagSet<E, N>>> sets, const FlagSet<E, N>& required, std::vector<std::size_t>& out) {
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+        if (sets[i].containsAll(required)) {
+            out.push_back(i);
+        }
+    }
+}
+
+template<typename E, std::size_t N>
+void filterAny(std::span<const std::type_identity_t<FlagSet<E, N>>> sets, const FlagSet<E, N>& mask, std::vector<std::size_t>& out) {
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+        if (sets[i].intersects(mask)) {
+            out.push_back(i);
+        }
+    }
+}
+
+template<typename E, std::size_t N>
+void filterNone(std::span<const std::type_identity_t<FlagSet<E, N>>> sets, const FlagSet<E, N>& excluded, std::vector<std::size_t>& out) {
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+        if (!sets[i].intersects(excluded)) {
+            out.push_back(i);
+        }
+    }
+}
+
+template<typename E, std::size_t N>
+void intersectEach(std::span<std::type_identity_t<FlagSet<E, N>>> sets, const FlagSet<E, N>& mask) noexcept {
+    for (auto& set : sets) {
+        set &= mask;
+    }
+}
+
+template<typename E, std::size_t N>
+void subtractEach(std::span<std::type_identity_t<FlagSet<E, N>>> sets, const FlagSet<E, N>& mask) noexcept {
+    for (auto& set : sets) {
+        set = set.andNot(mask);
+    }
+}
+
+template<typename E, std::size_t N>
+std::size_t countAll(std::span<const std::type_identity_t<FlagSet<E, N>>> sets, const FlagSet<E, N>& required) noexcept {
+    std::size_t total = 0;
+    for (const auto& set : sets) {
+        total += set.containsAll(required);
+    }
+    return total;
+}
+
+}  // namespace scl
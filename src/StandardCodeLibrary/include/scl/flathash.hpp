@@ -0,0 +1,544 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCL_FLATHASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace scl {
+
+// Default hasher: std::hash followed by a multiply-xorshift finalizer, because
+// std::hash on integers is usually the identity and the table needs good low
+// and high bits.
+template<typename K>
+struct Hash {
+    std::size_t operator()(const K& key) const noexcept {
+        std::uint64_t x = static_cast<std::uint64_t>(std::hash<K>{}(key));
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDull;
+        x ^= x >> 33;
+        return static_cast<std::size_t>(x);
+    }
+};
+
+// For keys that are already well mixed, e.g. StrHash::getHashValueObverse.
+struct IdentityHash {
+    template<typename K>
+    requires std::is_integral_v<K>
+    std::size_t operator()(K key) const noexcept {
+        return static_cast<std::size_t>(key);
+    }
+};
+
+namespace detail {
+
+using ctrl_t = std::int8_t;
+inline constexpr ctrl_t ctrlEmpty = -128;
+inline constexpr ctrl_t ctrlDeleted = -2;
+
+// 16 control bytes compared at once; bit i of a result refers to slot i.
+class Group {
+public:
+    static constexpr std::size_t width = 16;
+
+#ifdef SCL_FLATHASH_SSE2
+    explicit Group(const ctrl_t* p) noexcept
+        : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    std::uint32_t match(ctrl_t h2) const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+    }
+
+    std::uint32_t matchEmpty() const noexcept {
+        return match(ctrlEmpty);
+    }
+
+    std::uint32_t matchEmptyOrDeleted() const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl_));
+    }
+
+private:
+    __m128i ctrl_;
+#else
+    explicit Group(const ctrl_t* p) noexcept {
+        std::memcpy(ctrl_, p, width);
+    }
+
+    std::uint32_t match(ctrl_t h2) const noexcept {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            mask |= static_cast<std::uint32_t>(ctrl_[i] == h2) << i;
+        }
+        return mask;
+    }
+
+    std::uint32_t matchEmpty() const noexcept {
+        return match(ctrlEmpty);
+    }
+
+    std::uint32_t matchEmptyOrDeleted() const noexcept {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            mask |= static_cast<std::uint32_t>(ctrl_[i] < 0) << i;
+        }
+        return mask;
+    }
+
+private:
+    ctrl_t ctrl_[width];
+#endif
+};
+
+// Open addressing over groups of 16 slots with SwissTable control bytes: the
+// low 7 hash bits live in the control byte, so a probe touches one cache line
+// of metadata and compares keys only on a tag match. Slots are stored inline.
+template<typename K, typename Slot, typename KeyOf, typename HashFn, typename Eq>
+class FlatTable {
+public:
+    using key_type = K;
+    using value_type = Slot;
+    using size_type = std::size_t;
+    using hasher = HashFn;
+    using key_equal = Eq;
+
+    template<bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Slot;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const Slot*, Slot*>;
+        using reference = std::conditional_t<Const, const Slot&, Slot&>;
+
+        Iterator() noexcept = default;
+
+        template<bool C = Const>
+        requires C
+        Iterator(const Iterator<false>& other) noexcept
+            : table_(other.table_), index_(other.index_) {}
+
+        reference operator*() const noexcept {
+            return table_->slots_[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return table_->slots_ + index_;
+        }
+
+        Iterator& operator++() noexcept {
+            ++index_;
+            skipFree();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+    private:
+        friend class FlatTable;
+        friend class Iterator<!Const>;
+
+        using Table = std::conditional_t<Const, const FlatTable, FlatTable>;
+
+        Iterator(Table* table, std::size_t index) noexcept
+            : table_(table), index_(index) {}
+
+        void skipFree() noexcept {
+            while (index_ < table_->capacity() && table_->ctrl_[index_] < 0) {
+                ++index_;
+            }
+        }
+
+        Table* table_{};
+        std::size_t index_{};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatTable() = default;
+
+    explicit FlatTable(std::size_t n, const HashFn& hash = HashFn(), const Eq& eq = Eq())
+        : hash_(hash), eq_(eq) {
+        reserve(n);
+    }
+
+    FlatTable(const FlatTable& other)
+        : hash_(other.hash_), eq_(other.eq_) {
+        reserve(other.size_);
+        for (const Slot& slot : other) {
+            emplaceUnique(slot);
+        }
+    }
+
+    FlatTable(FlatTable&& other) noexcept {
+        swap(other);
+    }
+
+    FlatTable& operator=(FlatTable other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatTable() {
+        destroyAll();
+        deallocate(ctrl_, slots_, groups_);
+    }
+
+    void swap(FlatTable& other) noexcept {
+        using std::swap;
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(groups_, other.groups_);
+        swap(size_, other.size_);
+        swap(deleted_, other.deleted_);
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    std::size_t capacity() const noexcept {
+        return groups_ * Group::width;
+    }
+
+    iterator begin() noexcept {
+        iterator it{this, 0};
+        it.skipFree();
+        return it;
+    }
+
+    iterator end() noexcept {
+        return iterator{this, capacity()};
+    }
+
+    const_iterator begin() const noexcept {
+        const_iterator it{this, 0};
+        it.skipFree();
+        return it;
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator{this, capacity()};
+    }
+
+    void clear() noexcept {
+        destroyAll();
+        if (ctrl_ != nullptr) {
+            std::memset(ctrl_, static_cast<unsigned char>(ctrlEmpty), capacity());
+        }
+        size_ = deleted_ = 0;
+    }
+
+    // Sizes the table so that `n` elements fit without rehashing.
+    void reserve(std::size_t n) {
+        const std::size_t slots = n + (n + 6) / 7;
+        const std::size_t groups = std::bit_ceil((slots + Group::width - 1) / Group::width);
+        if (groups > groups_) {
+            rehash(groups);
+        }
+    }
+
+    iterator find(const K& key) noexcept {
+        return iterator{this, findIndex(key, hash_(key))};
+    }
+
+    const_iterator find(const K& key) const noexcept {
+        return const_iterator{this, findIndex(key, hash_(key))};
+    }
+
+    bool contains(const K& key) const noexcept {
+        return findIndex(key, hash_(key)) != capacity();
+    }
+
+    std::size_t count(const K& key) const noexcept {
+        return contains(key) ? 1 : 0;
+    }
+
+    // Pulls the key's first probe group into cache ahead of a find/insert,
+    // for batched lookups.
+    void prefetch(const K& key) const noexcept {
+        if (groups_ == 0) {
+            return;
+        }
+        const std::size_t g = (hash_(key) >> 7) & (groups_ - 1);
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(ctrl_ + g * Group::width);
+        __builtin_prefetch(slots_ + g * Group::width);
+#elif defined(SCL_FLATHASH_SSE2)
+        _mm_prefetch(reinterpret_cast<const char*>(ctrl_ + g * Group::width), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(slots_ + g * Group::width), _MM_HINT_T0);
+#endif
+    }
+
+    std::pair<iterator, bool> insert(const Slot& slot) {
+        return emplaceImpl(KeyOf{}(slot), slot);
+    }
+
+    std::pair<iterator, bool> insert(Slot&& slot) {
+        const K& key = KeyOf{}(slot);
+        return emplaceImpl(key, std::move(slot));
+    }
+
+    template<typename It>
+    void insert(It first, It last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>) {
+            reserve(size_ + static_cast<std::size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    std::size_t erase(const K& key) {
+        const std::size_t i = findIndex(key, hash_(key));
+        if (i == capacity()) {
+            return 0;
+        }
+        eraseAt(i);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        eraseAt(pos.index_);
+        iterator it{this, pos.index_};
+        it.skipFree();
+        return it;
+    }
+
+    iterator erase(iterator pos) {
+        return erase(const_iterator{pos});
+    }
+
+protected:
+    template<typename... Args>
+    std::pair<iterator, bool> emplaceImpl(const K& key, Args&&... args) {
+        const std::size_t hash = hash_(key);
+        std::size_t i = findIndex(key, hash);
+        if (i != capacity()) {
+            return {iterator{this, i}, false};
+        }
+        if (size_ + deleted_ >= maxLoad()) {
+            rehash(size_ + 1 > maxLoad() / 2 ? std::max<std::size_t>(1, groups_ * 2) : groups_);
+        }
+        i = findFreeSlot(hash);
+        std::construct_at(slots_ + i, std::forward<Args>(args)...);
+        if (ctrl_[i] == ctrlDeleted) {
+            --deleted_;
+        }
+        ctrl_[i] = h2(hash);
+        ++size_;
+        return {iterator{this, i}, true};
+    }
+
+private:
+    static ctrl_t h2(std::size_t hash) noexcept {
+        return static_cast<ctrl_t>(hash & 0x7F);
+    }
+
+    std::size_t maxLoad() const noexcept {
+        return capacity() - capacity() / 8;
+    }
+
+    std::size_t findIndex(const K& key, std::size_t hash) const noexcept {
+        if (groups_ == 0) {
+            return 0;
+        }
+        const ctrl_t tag = h2(hash);
+        std::size_t g = (hash >> 7) & (groups_ - 1);
+        for (std::size_t step = 1;; ++step) {
+            const Group group{ctrl_ + g * Group::width};
+            for (std::uint32_t m = group.match(tag); m != 0; m &= m - 1) {
+                const std::size_t i = g * Group::width + std::countr_zero(m);
+                if (eq_(KeyOf{}(slots_[i]), key)) {
+                    return i;
+                }
+            }
+            if (group.matchEmpty() != 0) {
+                return capacity();
+            }
+            g = (g + step) & (groups_ - 1);
+        }
+    }
+
+    std::size_t findFreeSlot(std::size_t hash) const noexcept {
+        std::size_t g = (hash >> 7) & (groups_ - 1);
+        for (std::size_t step = 1;; ++step) {
+            const std::uint32_t m = Group{ctrl_ + g * Group::width}.matchEmptyOrDeleted();
+            if (m != 0) {
+                return g * Group::width + std::countr_zero(m);
+            }
+            g = (g + step) & (groups_ - 1);
+        }
+    }
+
+    void eraseAt(std::size_t i) noexcept {
+        std::destroy_at(slots_ + i);
+        --size_;
+        // A group that still has an empty slot ends every probe passing
+        // through it, so the slot can go straight back to empty.
+        const std::size_t g = i / Group::width;
+        if (Group{ctrl_ + g * Group::width}.matchEmpty() != 0) {
+            ctrl_[i] = ctrlEmpty;
+        } else {
+            ctrl_[i] = ctrlDeleted;
+            ++deleted_;
+        }
+    }
+
+    void rehash(std::size_t groups) {
+        ctrl_t* oldCtrl = ctrl_;
+        Slot* oldSlots = slots_;
+        const std::size_t oldGroups = groups_;
+
+        const std::size_t cap = groups * Group::width;
+        ctrl_ = new ctrl_t[cap];
+        std::memset(ctrl_, static_cast<unsigned char>(ctrlEmpty), cap);
+        slots_ = std::allocator<Slot>{}.allocate(cap);
+        groups_ = groups;
+        deleted_ = 0;
+
+        for (std::size_t i = 0; i < oldGroups * Group::width; ++i) {
+            if (oldCtrl[i] >= 0) {
+                const std::size_t hash = hash_(KeyOf{}(oldSlots[i]));
+                const std::size_t j = findFreeSlot(hash);
+                std::construct_at(slots_ + j, std::move(oldSlots[i]));
+                std::destroy_at(oldSlots + i);
+                ctrl_[j] = h2(hash);
+            }
+        }
+        deallocate(oldCtrl, oldSlots, oldGroups);
+    }
+
+    void destroyAll() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<Slot>) {
+            for (std::size_t i = 0; i < capacity(); ++i) {
+                if (ctrl_[i] >= 0) {
+                    std::destroy_at(slots_ + i);
+                }
+            }
+        }
+    }
+
+    static void deallocate(ctrl_t* ctrl, Slot* slots, std::size_t groups) noexcept {
+        if (ctrl != nullptr) {
+            delete[] ctrl;
+            std::allocator<Slot>{}.deallocate(slots, groups * Group::width);
+        }
+    }
+
+    template<typename S>
+    void emplaceUnique(S&& slot) {
+        const std::size_t hash = hash_(KeyOf{}(slot));
+        const std::size_t i = findFreeSlot(hash);
+        std::construct_at(slots_ + i, std::forward<S>(slot));
+        ctrl_[i] = h2(hash);
+        ++size_;
+    }
+
+    [[no_unique_address]] HashFn hash_{};
+    [[no_unique_address]] Eq eq_{};
+    ctrl_t* ctrl_{};
+    Slot* slots_{};
+    std::size_t groups_{};
+    std::size_t size_{};
+    std::size_t deleted_{};
+};
+
+struct MapKeyOf {
+    template<typename P>
+    const auto& operator()(const P& slot) const noexcept {
+        return slot.first;
+    }
+};
+
+struct SetKeyOf {
+    template<typename K>
+    const K& operator()(const K& slot) const noexcept {
+        return slot;
+    }
+};
+
+}  // namespace detail
+
+// Elements are std::pair<K, V> (not pair<const K, V>) so they can be moved
+// during rehash; never modify a key in place. Rehash invalidates iterators
+// and references.
+template<typename K, typename V, typename HashFn = Hash<K>, typename Eq = std::equal_to<K>>
+class FlatHashMap : public detail::FlatTable<K, std::pair<K, V>, detail::MapKeyOf, HashFn, Eq> {
+    using Base = detail::FlatTable<K, std::pair<K, V>, detail::MapKeyOf, HashFn, Eq>;
+
+public:
+    using mapped_type = V;
+    using typename Base::iterator;
+
+    using Base::Base;
+
+    template<typename... Args>
+    std::pair<iterator, bool> tryEmplace(const K& key, Args&&... args) {
+        return this->emplaceImpl(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insertOrAssign(const K& key, M&& value) {
+        auto res = tryEmplace(key, std::forward<M>(value));
+        if (!res.second) {
+            res.first->second = std::forward<M>(value);
+        }
+        return res;
+    }
+
+    V& operator[](const K& key) {
+        return tryEmplace(key).first->second;
+    }
+
+    V& at(const K& key) {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("FlatHashMap::at");
+        }
+        return it->second;
+    }
+
+    const V& at(const K& key) const {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("FlatHashMap::at");
+        }
+        return it->second;
+    }
+};
+
+template<typename K, typename HashFn = Hash<K>, typename Eq = std::equal_to<K>>
+class FlatHashSet : public detail::FlatTable<K, K, detail::SetKeyOf, HashFn, Eq> {
+    using Base = detail::FlatTable<K, K, detail::SetKeyOf, HashFn, Eq>;
+
+public:
+    using Base::Base;
+};
+
+}  // namespace scl
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "scl/cacheline.hpp"
+
+namespace scl {
+
+namespace detail {
+
+template<typename T>
+struct RingSlot {
+    alignas(T) std::byte data[sizeof(T)];
+
+    T* get() noexcept {
+        return std::launder(reinterpret_cast<T*>(data));
+    }
+};
+
+// Spin, then yield, then sleep on `word` (a futex on Linux, WaitOnAddress on
+// Windows). `waiters` lets the other side skip the wake-up syscall when
+// nobody is asleep.
+template<typename Index, typename Ready>
+void blockUntil(const std::atomic<Index>& word, std::atomic<int>& waiters, Ready ready) {
+    for (unsigned i = 0; !ready(); ++i) {
+        if (i < 64) {
+            cpuRelax();
+        } else if (i < 128) {
+            std::this_thread::yield();
+        } else {
+            const Index seen = word.load(std::memory_order_seq_cst);
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            // pairs with the fence in the waker: either it sees us or we see its data
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready()) {
+                word.wait(seen, std::memory_order_seq_cst);
+            }
+            waiters.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+}
+
+template<typename Index>
+void wakeWaiters(std::atomic<Index>& word, const std::atomic<int>& waiters) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) > 0) {
+        word.notify_all();
+    }
+}
+
+}  // namespace detail
+
+// Bounded single-producer single-consumer ring. Each side keeps a cached copy
+// of the other side's index and only rereads it when the cache says full/empty.
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+          slots_(std::make_unique<detail::RingSlot<T>[]>(mask_ + 1)) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue() {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        for (std::size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+            std::destroy_at(slots_[i & mask_].get());
+        }
+    }
+
+    std::size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    std::size_t sizeApprox() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    template<typename... Args>
+    bool tryEmplace(Args&&... args) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ > mask_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ > mask_) {
+                return false;
+            }
+        }
+        std::construct_at(slots_[tail & mask_].get(), std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        detail::wakeWaiters(tail_, popWaiters_);
+        return true;
+    }
+
+    bool tryPush(const T& value) {
+        return tryEmplace(value);
+    }
+
+    bool tryPush(T&& value) {
+        return tryEmplace(std::move(value));
+    }
+
+    void push(T value) {
+        detail::blockUntil(head_, pushWaiters_, [&] {
+            return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) <= mask_;
+        });
+        tryEmplace(std::move(value));
+    }
+
+    bool tryPop(T& out) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_) {
+                return false;
+            }
+        }
+        T* slot = slots_[head & mask_].get();
+        out = std::move(*slot);
+        std::destroy_at(slot);
+        head_.store(head + 1, std::memory_order_release);
+        detail::wakeWaiters(head_, pushWaiters_);
+        return true;
+    }
+
+    T pop() {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        detail::blockUntil(tail_, popWaiters_, [&] {
+            return tail_.load(std::memory_order_acquire) != head;
+        });
+        T* slot = slots_[head & mask_].get();
+        T out(std::move(*slot));
+        std::destroy_at(slot);
+        head_.store(head + 1, std::memory_order_release);
+        detail::wakeWaiters(head_, pushWaiters_);
+        return out;
+    }
+
+    // Pushes as many of [first, last) as fit and publishes them with a single
+    // index store. Returns the iterator one past the last element pushed.
+    template<typename It>
+    It tryPushBatch(It first, It last) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        headCache_ = head_.load(std::memory_order_acquire);
+        const std::size_t room = capacity() - (tail - headCache_);
+        std::size_t n = 0;
+        for (; n < room && first != last; ++n, ++first) {
+            std::construct_at(slots_[(tail + n) & mask_].get(), *first);
+        }
+        if (n != 0) {
+            tail_.store(tail + n, std::memory_order_release);
+            detail::wakeWaiters(tail_, popWaiters_);
+        }
+        return first;
+    }
+
+    // Pops up to `max` elements into `out`; returns how many were popped.
+    template<typename Out>
+    std::size_t tryPopBatch(Out out, std::size_t max) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        tailCache_ = tail_.load(std::memory_order_acquire);
+        const std::size_t n = std::min(max, tailCache_ - head);
+        for (std::size_t i = 0; i < n; ++i) {
+            T* slot = slots_[(head + i) & mask_].get();
+            *out++ = std::move(*slot);
+            std::destroy_at(slot);
+        }
+        if (n != 0) {
+            head_.store(head + n, std::memory_order_release);
+            detail::wakeWaiters(head_, pushWaiters_);
+        }
+        return n;
+    }
+
+private:
+    const std::size_t mask_;
+    std::unique_ptr<detail::RingSlot<T>[]> slots_;
+
+    alignas(cacheLineSize) std::atomic<std::size_t> tail_{0};
+    std::size_t headCache_{0};
+    std::atomic<int> pushWaiters_{0};
+
+    alignas(cacheLineSize) std::atomic<std::size_t> head_{0};
+    std::size_t tailCache_{0};
+    std::atomic<int> popWaiters_{0};
+};
+
+// Bounded multi-producer multi-consumer queue after Dmitry Vyukov: every cell
+// carries a sequence number telling producers and consumers whose turn it is.
+// A slot is claimed by moving a position and published later by its sequence
+// store, so the blocking calls sleep on separate counters bumped after the
+// publish rather than on the positions. Once claimed, a cell must be
+// published, so a value whose constructor may throw is built before the
+// claim and moved in: that needs a non-throwing move, and such a value is
+// built (consuming rvalue arguments) even when the queue turns out full.
+template<typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+          cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue() {
+        const std::size_t tail = enqueuePos_.load(std::memory_order_relaxed);
+        for (std::size_t i = dequeuePos_.load(std::memory_order_relaxed); i != tail; ++i) {
+            std::destroy_at(cells_[i & mask_].slot.get());
+        }
+    }
+
+    std::size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    std::size_t sizeApprox() const noexcept {
+        const std::size_t tail = enqueuePos_.load(std::memory_order_acquire);
+        const std::size_t head = dequeuePos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    template<typename... Args>
+    bool tryEmplace(Args&&... args) {
+        if (!emplaceNoWake(std::forward<Args>(args)...)) {
+            return false;
+        }
+        published(pushed_, popWaiters_);
+        return true;
+    }
+
+    bool tryPush(const T& value) {
+        return tryEmplace(value);
+    }
+
+    bool tryPush(T&& value) {
+        return tryEmplace(std::move(value));
+    }
+
+    void push(T value) {
+        while (!tryEmplace(std::move(value))) {
+            const std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+            detail::blockUntil(popped_, pushWaiters_, [&] {
+                const Cell& cell = cells_[pos & mask_];
+                return cell.sequence.load(std::memory_order_acquire) == pos
+                    || enqueuePos_.load(std::memory_order_relaxed) != pos;
+            });
+        }
+    }
+
+    bool tryPop(T& out) {
+        if (!popNoWake([&](T&& value) { out = std::move(value); })) {
+            return false;
+        }
+        published(popped_, pushWaiters_);
+        return true;
+    }
+
+    T pop() {
+        std::optional<T> out;
+        while (!popNoWake([&](T&& value) { out.emplace(std::move(value)); })) {
+            const std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            detail::blockUntil(pushed_, popWaiters_, [&] {
+                const Cell& cell = cells_[pos & mask_];
+                return cell.sequence.load(std::memory_order_acquire) == pos + 1
+                    || dequeuePos_.load(std::memory_order_relaxed) != pos;
+            });
+        }
+        published(popped_, pushWaiters_);
+        return std::move(*out);
+    }
+
+    // Batches pay for at most one wake-up each, which is where contended
+    // queues spend most of their time.
+    template<typename It>
+    It tryPushBatch(It first, It last) {
+        bool pushed = false;
+        for (; first != last && emplaceNoWake(*first); ++first) {
+            pushed = true;
+        }
+        if (pushed) {
+            published(pushed_, popWaiters_);
+        }
+        return first;
+    }
+
+    template<typename Out>
+    std::size_t tryPopBatch(Out out, std::size_t max) {
+        std::size_t n = 0;
+        for (; n < max && popNoWake([&](T&& value) { *out++ = std::move(value); }); ++n) {}
+        if (n != 0) {
+            published(popped_, pushWaiters_);
+        }
+        return n;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        detail::RingSlot<T> slot;
+    };
+
+    template<typename... Args>
+    bool emplaceNoWake(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            return claimAndConstruct(std::forward<Args>(args)...);
+        } else {
+            static_assert(std::is_nothrow_move_constructible_v<T>,
+                          "MpmcQueue needs a non-throwing move to build values outside the cell");
+            T value(std::forward<Args>(args)...);
+            return claimAndConstruct(std::move(value));
+        }
+    }
+
+    template<typename... Args>
+    bool claimAndConstruct(Args&&... args) {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::construct_at(cell.slot.get(), std::forward<Args>(args)...);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Bumped only while someone sleeps, so the uncontended path stays one
+    // fence and a load.
+    static void published(std::atomic<std::uint32_t>& counter, const std::atomic<int>& waiters) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            counter.fetch_add(1, std::memory_order_seq_cst);
+            counter.notify_all();
+        }
+    }
+
+    // Hands the value to `consume` as an rvalue, then frees the cell even if
+    // `consume` throws, waking producers in that case since the caller will
+    // not get to.
+    template<typename Consume>
+    bool popNoWake(Consume&& consume) {
+        std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    struct Release {
+                        MpmcQueue& queue;
+                        Cell& cell;
+                        std::size_t next;
+                        bool consumed = false;
+
+                        ~Release() {
+                            std::destroy_at(cell.slot.get());
+                            cell.sequence.store(next, std::memory_order_release);
+                            if (!consumed) {
+                                published(queue.popped_, queue.pushWaiters_);
+                            }
+                        }
+                    } release{*this, cell, pos + mask_ + 1};
+                    consume(std::move(*cell.slot.get()));
+                    release.consumed = true;
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(cacheLineSize) std::atomic<std::size_t> enqueuePos_{0};
+    std::atomic<std::uint32_t> pushed_{0};
+    std::atomic<int> pushWaiters_{0};
+
+    alignas(cacheLineSize) std::atomic<std::size_t> dequeuePos_{0};
+    std::atomic<std::uint32_t> popped_{0};
+    std::atomic<int> popWaiters_{0};
+};
+
+}  // namespace scl
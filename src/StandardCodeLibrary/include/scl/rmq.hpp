@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <bit>
+#include <memory_resource>
+#include <span>
 
 template<class T, class Cmp = std::less<T>>
 struct RMQ {
@@ -10,32 +15,46 @@ struct RMQ {
 
     const Cmp cmp = Cmp();
     int n{};
-    std::vector<std::vector<T>> a;
-    std::vector<T> pre, suf, ini;
-    std::vector<u64> stk;
+    int M{};
+    // sparse table over block minima, level k stored at a[k * M, (k + 1) * M)
+    std::pmr::vector<T> a;
+    std::pmr::vector<T> pre, suf, ini;
+    std::pmr::vector<u64> stk;
 
+    // The tables live in `mr`. Copies follow std::pmr and allocate from the
+    // default resource, not the source's; moves keep the source's resource.
     RMQ() = default;
-    explicit RMQ(const std::vector<T>& v) {
+    explicit RMQ(std::pmr::memory_resource* mr) : a(mr), pre(mr), suf(mr), ini(mr), stk(mr) {}
+    explicit RMQ(std::span<const T> v, std::pmr::memory_resource* mr = std::pmr::get_default_resource()) : RMQ(mr) {
         init(v);
     }
+    // Keeps RMQ<int> r({...}) and other brace-initialized calls compiling.
+    explicit RMQ(const std::vector<T>& v, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : RMQ(std::span<const T>(v), mr) {}
 
     void init(const std::vector<T>& v) {
+        init(std::span<const T>(v));
+    }
+
+    void init(std::span<const T> v) {
         n = static_cast<int>(v.size());
-        pre = suf = ini = v;
+        pre.assign(v.begin(), v.end());
+        suf.assign(v.begin(), v.end());
+        ini.assign(v.begin(), v.end());
         stk.resize(n);
 
         if (n == 0) {
             return;
         }
 
-        const int M = (n - 1) / B + 1;
+        M = (n - 1) / B + 1;
         const int lg = std::bit_width(static_cast<unsigned>(M)) - 1;
-        a.assign(lg + 1, std::vector<T>(M));
+        a.assign(static_cast<std::size_t>(lg + 1) * M, T{});
 
         for (int i = 0; i < M; ++i) {
-            a[0][i] = v[i * B];
+            a[i] = v[i * B];
             for (int j = 1; j < B && i * B + j < n; ++j) {
-                a[0][i] = std::min(a[0][i], v[i * B + j], cmp);
+                a[i] = std::min(a[i], v[i * B + j], cmp);
             }
         }
 
@@ -53,7 +72,7 @@ struct RMQ {
 
         for (int j = 0; j < lg; ++j) {
             for (int i = 0; i + (2 << j) <= M; ++i) {
-                a[j + 1][i] = std::min(a[j][i], a[j][i + (1 << j)], cmp);
+                a[(j + 1) * M + i] = std::min(a[j * M + i], a[j * M + i + (1 << j)], cmp);
             }
         }
 
@@ -78,7 +97,7 @@ struct RMQ {
             int rb = r / B;
             if (lb < rb) {
                 int k = std::bit_width(static_cast<unsigned>(rb - lb)) - 1;
-                ans = std::min({ans, a[k][lb], a[k][rb - (1 << k)]}, cmp);
+                ans = std::min({ans, a[k * M + lb], a[k * M + rb - (1 << k)]}, cmp);
             }
             return ans;
         } else {
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace scl {
+
+// Bottom-up lazy segment tree over an implicit heap (Eytzinger) layout: node
+// k has children 2k and 2k + 1 and the leaves are [size, 2 * size), so a
+// query walks two index paths up the tree with no recursion or pointers.
+//
+// Info: default-constructed is the identity of `+`, which must be
+//       associative; `void apply(const Tag&)` updates a whole node.
+// Tag:  default-constructed is the no-op update; `void apply(const Tag& t)`
+//       composes t on top of the current tag.
+template<class Info, class Tag>
+class LazySegmentTree {
+public:
+    LazySegmentTree() = default;
+
+    // Info{} is the identity, not an element: the Infos below need a real
+    // value such as SumInfo<T>(0) to count as covering one element.
+    LazySegmentTree(int n, const Info& v) : LazySegmentTree(std::vector<Info>(n, v)) {}
+
+    explicit LazySegmentTree(std::span<const Info> init) {
+        n_ = static_cast<int>(init.size());
+        size_ = static_cast<int>(std::bit_ceil(static_cast<unsigned>(std::max(n_, 1))));
+        log_ = std::countr_zero(static_cast<unsigned>(size_));
+        info_.assign(2 * size_, Info{});
+        tag_.assign(size_, Tag{});
+        std::ranges::copy(init, info_.begin() + size_);
+        for (int k = size_ - 1; k >= 1; --k) {
+            pull(k);
+        }
+    }
+
+    int size() const {
+        return n_;
+    }
+
+    void set(int p, const Info& v) {
+        assert(0 <= p && p < n_);
+        p += size_;
+        pushPath(p);
+        info_[p] = v;
+        pullPath(p);
+    }
+
+    Info get(int p) {
+        assert(0 <= p && p < n_);
+        p += size_;
+        pushPath(p);
+        return info_[p];
+    }
+
+    // [l, r)
+    Info query(int l, int r) {
+        assert(0 <= l && l <= r && r <= n_);
+        if (l == r) {
+            return Info{};
+        }
+        l += size_;
+        r += size_;
+        pushBounds(l, r);
+
+        Info left, right;
+        for (; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) {
+                left = left + info_[l++];
+            }
+            if (r & 1) {
+                right = info_[--r] + right;
+            }
+        }
+        return left + right;
+    }
+
+    Info all() const {
+        return info_[1];
+    }
+
+    void apply(int p, const Tag& t) {
+        assert(0 <= p && p < n_);
+        p += size_;
+        pushPath(p);
+        info_[p].apply(t);
+        pullPath(p);
+    }
+
+    // [l, r)
+    void apply(int l, int r, const Tag& t) {
+        assert(0 <= l && l <= r && r <= n_);
+        if (l == r) {
+            return;
+        }
+        l += size_;
+        r += size_;
+        pushBounds(l, r);
+
+        for (int a = l, b = r; a < b; a >>= 1, b >>= 1) {
+            if (a & 1) {
+                applyNode(a++, t);
+            }
+            if (b & 1) {
+                applyNode(--b, t);
+            }
+        }
+
+        for (int i = 1; i <= log_; ++i) {
+            if (((l >> i) << i) != l) {
+                pull(l >> i);
+            }
+            if (((r >> i) << i) != r) {
+                pull((r - 1) >> i);
+            }
+        }
+    }
+
+private:
+    void pull(int k) {
+        info_[k] = info_[2 * k] + info_[2 * k + 1];
+    }
+
+    void applyNode(int k, const Tag& t) {
+        info_[k].apply(t);
+        if (k < size_) {
+            tag_[k].apply(t);
+        }
+    }
+
+    void push(int k) {
+        applyNode(2 * k, tag_[k]);
+        applyNode(2 * k + 1, tag_[k]);
+        tag_[k] = Tag{};
+    }
+
+    void pushPath(int leaf) {
+        for (int i = log_; i >= 1; --i) {
+            push(leaf >> i);
+        }
+    }
+
+    void pullPath(int leaf) {
+        for (int i = 1; i <= log_; ++i) {
+            pull(leaf >> i);
+        }
+    }
+
+    // Pushes tags above the boundaries of [l, r); nodes fully inside keep
+    // theirs, which is what makes updates O(log n).
+    void pushBounds(int l, int r) {
+        for (int i = log_; i >= 1; --i) {
+            if (((l >> i) << i) != l) {
+                push(l >> i);
+            }
+            if (((r >> i) << i) != r) {
+                push((r - 1) >> i);
+            }
+        }
+    }
+
+    int n_{};
+    int size_{};
+    int log_{};
+    std::vector<Info> info_;
+    std::vector<Tag> tag_;
+};
+
+// Range add and range assign; an assign discards earlier adds.
+template<class T>
+struct AddAssignTag {
+    bool assign = false;
+    T value{};
+    T add{};
+
+    static AddAssignTag makeAdd(T v) {
+        return {false, T{}, v};
+    }
+
+    static AddAssignTag makeAssign(T v) {
+        return {true, v, T{}};
+    }
+
+    void apply(const AddAssignTag& t) {
+        if (t.assign) {
+            *this = t;
+        } else {
+            add += t.add;
+        }
+    }
+};
+
+// The Infos below carry the number of elements they cover, both to scale
+// sums and so that the identity (len == 0) is never updated.
+template<class T>
+struct SumInfo {
+    T sum{};
+    long long len = 0;
+
+    SumInfo() = default;
+    SumInfo(T v) : sum(v), len(1) {}
+
+    void apply(const AddAssignTag<T>& t) {
+        if (t.assign) {
+            sum = t.value * static_cast<T>(len);
+        }
+        sum += t.add * static_cast<T>(len);
+    }
+
+    friend SumInfo operator+(const SumInfo& a, const SumInfo& b) {
+        SumInfo c;
+        c.sum = a.sum + b.sum;
+        c.len = a.len + b.len;
+        return c;
+    }
+};
+
+template<class T>
+struct MinInfo {
+    T min = std::numeric_limits<T>::max();
+    long long len = 0;
+
+    MinInfo() = default;
+    MinInfo(T v) : min(v), len(1) {}
+
+    void apply(const AddAssignTag<T>& t) {
+        if (len == 0) {
+            return;
+        }
+        if (t.assign) {
+            min = t.value;
+        }
+        min += t.add;
+    }
+
+    friend MinInfo operator+(const MinInfo& a, const MinInfo& b) {
+        MinInfo c;
+        c.min = std::min(a.min, b.min);
+        c.len = a.len + b.len;
+        return c;
+    }
+};
+
+template<class T>
+struct MaxInfo {
+    T max = std::numeric_limits<T>::lowest();
+    long long len = 0;
+
+    MaxInfo() = default;
+    MaxInfo(T v) : max(v), len(1) {}
+
+    void apply(const AddAssignTag<T>& t) {
+        if (len == 0) {
+            return;
+        }
+        if (t.assign) {
+            max = t.value;
+        }
+        max += t.add;
+    }
+
+    friend MaxInfo operator+(const MaxInfo& a, const MaxInfo& b) {
+        MaxInfo c;
+        c.max = std::max(a.max, b.max);
+        c.len = a.len + b.len;
+        return c;
+    }
+};
+
+}  // namespace scl
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
-#include <string>
+#include <string_view>
 #include <array>
 #include <cassert>
 
@@ -15,34 +16,38 @@ class StrHash {
     static constexpr std::array<int, 2> mod = {1000000033, 1000002233};
 
     const int n;
-    std::vector<std::vector<i64>> h, rh, pw;
+    // both moduli interleaved: x[2 * i + k] is position i under mod[k]
+    std::pmr::vector<i64> h, rh, pw;
 
 public:
-    explicit StrHash(const std::string& s) : n(s.size()), h(2, std::vector<i64>(n + 1)), rh(2, std::vector<i64>(n + 1)), pw(h) {
-        pw[0][0] = pw[1][0] = 1ll;
+    explicit StrHash(std::string_view s, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : n(s.size()), h(2 * (n + 1), mr), rh(2 * (n + 1), mr), pw(2 * (n + 1), mr) {
+        pw[0] = pw[1] = 1ll;
         for (int i = 1; i <= n; ++i) {
-            pw[0][i] = pw[0][i - 1] * p[0] % mod[0];
-            pw[1][i] = pw[1][i - 1] * p[1] % mod[1];
+            pw[2 * i] = pw[2 * i - 2] * p[0] % mod[0];
+            pw[2 * i + 1] = pw[2 * i - 1] * p[1] % mod[1];
         }
         for (int i = 1; i <= n; ++i) {
-            h[0][i] = (h[0][i - 1] * p[0] + s[i - 1]) % mod[0];
-            h[1][i] = (h[1][i - 1] * p[1] + s[i - 1]) % mod[1];
+            h[2 * i] = (h[2 * i - 2] * p[0] + s[i - 1]) % mod[0];
+            h[2 * i + 1] = (h[2 * i - 1] * p[1] + s[i - 1]) % mod[1];
         }
         for (int i = n - 1; i >= 0; --i) {
-            rh[0][i] = (rh[0][i + 1] * p[0] + s[i]) % mod[0];
-            rh[1][i] = (rh[1][i + 1] * p[1] + s[i]) % mod[1];
+            rh[2 * i] = (rh[2 * i + 2] * p[0] + s[i]) % mod[0];
+            rh[2 * i + 1] = (rh[2 * i + 3] * p[1] + s[i]) % mod[1];
         }
     }
 
-    i64 getHashValueObverse(int l, int r) {
+    i64 getHashValueObverse(int l, int r) const {
         assert(0 <= l && l <= r && r < n);
-        return (((h[0][r + 1] - h[0][l] * pw[0][r - l + 1] % mod[0] + mod[0]) % mod[0]) << 30)
-            + (h[1][r + 1] - h[1][l] * pw[1][r - l + 1] % mod[1] + mod[1]) % mod[1];
+        const int len = r - l + 1;
+        return (((h[2 * r + 2] - h[2 * l] * pw[2 * len] % mod[0] + mod[0]) % mod[0]) << 30)
+            + (h[2 * r + 3] - h[2 * l + 1] * pw[2 * len + 1] % mod[1] + mod[1]) % mod[1];
     }
-    i64 getHashValueReverse(int l, int r) {
+    i64 getHashValueReverse(int l, int r) const {
         assert(0 <= l && l <= r && r < n);
-        return (((rh[0][l] - rh[0][r + 1] * pw[0][r - l + 1] % mod[0] + mod[0]) % mod[0]) << 30)
-            + (rh[1][l] - rh[1][r + 1] * pw[1][r - l + 1] % mod[1] + mod[1]) % mod[1];
+        const int len = r - l + 1;
+        return (((rh[2 * l] - rh[2 * r + 2] * pw[2 * len] % mod[0] + mod[0]) % mod[0]) << 30)
+            + (rh[2 * l + 1] - rh[2 * r + 3] * pw[2 * len + 1] % mod[1] + mod[1]) % mod[1];
     }
 };
 
@@ -0,0 +1,483 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "scl/cacheline.hpp"
+#include "scl/singleton.hpp"
+
+namespace scl {
+
+class Task {
+public:
+    Task() = default;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool done() const noexcept {
+        return done_.load(std::memory_order_acquire);
+    }
+
+protected:
+    ~Task() = default;
+
+    virtual void execute() = 0;
+
+private:
+    friend class ThreadPool;
+
+    void run() noexcept {
+        try {
+            execute();
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+        done_.store(true, std::memory_order_release);
+    }
+
+    std::atomic<bool> done_{false};
+    std::exception_ptr error_;
+    // submitted from outside the pool, so its waiter may be asleep
+    bool external_{false};
+};
+
+template<typename F>
+class FunctionTask final : public Task {
+public:
+    explicit FunctionTask(F f) : f_(std::move(f)) {}
+
+private:
+    void execute() override {
+        f_();
+    }
+
+    F f_;
+};
+
+// Chase-Lev deque: the owner pushes and pops at the bottom, thieves take from
+// the top. Capacity is fixed; a failed push makes the caller run the task inline.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 1 << 13)
+        : mask_(std::bit_ceil(capacity) - 1), buffer_(std::make_unique<std::atomic<Task*>[]>(mask_ + 1)) {}
+
+    bool push(Task* task) noexcept {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t > static_cast<std::int64_t>(mask_)) {
+            return false;
+        }
+        buffer_[b & mask_].store(task, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    Task* pop() noexcept {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        Task* task = nullptr;
+        if (t <= b) {
+            task = buffer_[b & mask_].load(std::memory_order_relaxed);
+            if (t == b) {
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    task = nullptr;
+                }
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task* steal() noexcept {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Task* task = buffer_[t & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+private:
+    alignas(cacheLineSize) std::atomic<std::int64_t> top_{0};
+    alignas(cacheLineSize) std::atomic<std::int64_t> bottom_{0};
+    alignas(cacheLineSize) std::size_t mask_;
+    std::unique_ptr<std::atomic<Task*>[]> buffer_;
+};
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency()), bool pinThreads = false)
+        : workers_(threads) {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_[i].rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_[i].thread = std::thread([this, i, pinThreads] {
+                if (pinThreads) {
+                    pinToCore(i);
+                }
+                workerLoop(i);
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        stop_.store(true, std::memory_order_seq_cst);
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        epoch_.notify_all();
+        for (auto& worker : workers_) {
+            worker.thread.join();
+        }
+    }
+
+    static ThreadPool& global() {
+        return Singlton<ThreadPool, false>::GetInstance();
+    }
+
+    unsigned size() const noexcept {
+        return static_cast<unsigned>(workers_.size());
+    }
+
+    void submit(Task& task) {
+        if (currentPool_ == this) {
+            if (!workers_[currentIndex_].deque.push(&task)) {
+                task.run();
+                return;
+            }
+        } else {
+            task.external_ = true;
+            std::lock_guard lock(injectorMutex_);
+            injector_.push_back(&task);
+            injectorSize_.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake();
+    }
+
+    // A worker runs other pending work until `task` finishes, so nested
+    // parallel calls never block it. Any other thread sleeps instead: helping
+    // from outside would take the injector's oldest, widest tasks and nest
+    // without bound. With no workers at all it has to help.
+    void wait(Task& task) {
+        if (currentPool_ != this && !workers_.empty()) {
+            waitOutside(task);
+        }
+        for (unsigned spins = 0; !task.done();) {
+            if (Task* other = findWork()) {
+                execute(other);
+                spins = 0;
+            } else if (++spins < 64) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (task.error_) {
+            std::rethrow_exception(task.error_);
+        }
+    }
+
+    // Runs f and g, possibly in parallel. From outside the pool the pair is
+    // handed to a worker as one task so the forks below it land on worker deques.
+    template<typename F, typename G>
+    void invoke(F&& f, G&& g) {
+        if (currentPool_ != this) {
+            if (workers_.empty()) {
+                f();
+                g();
+                return;
+            }
+            FunctionTask root{[&] { invoke(f, g); }};
+            submit(root);
+            wait(root);
+            return;
+        }
+
+        FunctionTask right{[&g] { g(); }};
+        submit(right);
+        try {
+            f();
+        } catch (...) {
+            wait(right);
+            throw;
+        }
+        wait(right);
+    }
+
+private:
+    struct Worker {
+        WorkStealingDeque deque;
+        std::thread thread;
+        std::uint64_t rng{};
+    };
+
+    static void pinToCore(unsigned index) noexcept {
+        const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+#if defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << (index % cores % 64));
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)index;
+        (void)cores;
+#endif
+    }
+
+    void execute(Task* task) {
+        // read before run(): the waiter may destroy the task once it is done
+        const bool external = task->external_;
+        task->run();
+        if (external) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (outsideWaiters_.load(std::memory_order_seq_cst) > 0) {
+                finished_.fetch_add(1, std::memory_order_seq_cst);
+                finished_.notify_all();
+            }
+        }
+    }
+
+    void waitOutside(const Task& task) {
+        for (unsigned spins = 0; spins < 64 && !task.done(); ++spins) {
+            std::this_thread::yield();
+        }
+        outsideWaiters_.fetch_add(1, std::memory_order_seq_cst);
+        for (;;) {
+            const std::uint32_t seen = finished_.load(std::memory_order_seq_cst);
+            if (task.done_.load(std::memory_order_seq_cst)) {
+                break;
+            }
+            finished_.wait(seen, std::memory_order_seq_cst);
+        }
+        outsideWaiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            epoch_.fetch_add(1, std::memory_order_seq_cst);
+            epoch_.notify_one();
+        }
+    }
+
+    Task* findWork() {
+        std::uint64_t seed = 0;
+        if (currentPool_ == this) {
+            Worker& self = workers_[currentIndex_];
+            if (Task* task = self.deque.pop()) {
+                return task;
+            }
+            self.rng ^= self.rng << 13;
+            self.rng ^= self.rng >> 7;
+            self.rng ^= self.rng << 17;
+            seed = self.rng;
+        } else {
+            seed = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        }
+
+        if (injectorSize_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard lock(injectorMutex_);
+            if (!injector_.empty()) {
+                Task* task = injector_.front();
+                injector_.pop_front();
+                injectorSize_.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+
+        const std::size_t n = workers_.size();
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t victim = (seed + k) % n;
+            if (currentPool_ == this && victim == currentIndex_) {
+                continue;
+            }
+            if (Task* task = workers_[victim].deque.steal()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void workerLoop(unsigned index) {
+        currentPool_ = this;
+        currentIndex_ = index;
+        unsigned idle = 0;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            if (Task* task = findWork()) {
+                execute(task);
+                idle = 0;
+                continue;
+            }
+            if (++idle < 256) {
+                cpuRelax();
+                continue;
+            }
+
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+            if (Task* task = findWork()) {
+                sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+                execute(task);
+                idle = 0;
+                continue;
+            }
+            if (!stop_.load(std::memory_order_seq_cst)) {
+                epoch_.wait(epoch, std::memory_order_seq_cst);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+            idle = 0;
+        }
+        currentPool_ = nullptr;
+    }
+
+    inline static thread_local ThreadPool* currentPool_ = nullptr;
+    inline static thread_local unsigned currentIndex_ = 0;
+
+    std::vector<Worker> workers_;
+    std::mutex injectorMutex_;
+    std::deque<Task*> injector_;
+    std::atomic<std::size_t> injectorSize_{0};
+    alignas(cacheLineSize) std::atomic<std::uint64_t> epoch_{0};
+    alignas(cacheLineSize) std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+    alignas(cacheLineSize) std::atomic<std::uint32_t> finished_{0};
+    std::atomic<int> outsideWaiters_{0};
+};
+
+namespace detail {
+
+template<typename Index, typename F>
+void splitRange(ThreadPool& pool, Index lo, Index hi, Index grain, F& body) {
+    if (hi - lo <= grain) {
+        body(lo, hi);
+        return;
+    }
+    const Index mid = lo + (hi - lo) / 2;
+    pool.invoke(
+        [&] { splitRange(pool, lo, mid, grain, body); },
+        [&] { splitRange(pool, mid, hi, grain, body); });
+}
+
+template<typename Index>
+Index autoGrain(Index n, std::size_t grain, const ThreadPool& pool) {
+    if (grain != 0) {
+        return static_cast<Index>(grain);
+    }
+    const auto workers = static_cast<Index>(std::max(1u, pool.size()));
+    return std::max<Index>(1, static_cast<Index>(n / (8 * workers)));
+}
+
+}  // namespace detail
+
+// body(lo, hi) is called on disjoint subranges no longer than `grain`;
+// a grain of 0 picks about eight chunks per worker.
+template<typename Index, typename F>
+requires std::is_integral_v<Index>
+void parallelFor(Index first, Index last, std::size_t grain, F&& body, ThreadPool& pool = ThreadPool::global()) {
+    if (first >= last) {
+        return;
+    }
+    detail::splitRange(pool, first, last, detail::autoGrain(last - first, grain, pool), body);
+}
+
+// body(lo, hi) reduces one subrange; reduce must be associative.
+template<typename Index, typename T, typename F, typename R>
+requires std::is_integral_v<Index>
+T parallelReduce(Index first, Index last, std::size_t grain, T identity, F&& body, R&& reduce, ThreadPool& pool = ThreadPool::global()) {
+    if (first >= last) {
+        return identity;
+    }
+    const Index step = detail::autoGrain(last - first, grain, pool);
+    auto rec = [&](auto& self, Index lo, Index hi) -> T {
+        if (hi - lo <= step) {
+            return body(lo, hi);
+        }
+        const Index mid = lo + (hi - lo) / 2;
+        T left = identity, right = identity;
+        pool.invoke([&] { left = self(self, lo, mid); }, [&] { right = self(self, mid, hi); });
+        return reduce(std::move(left), std::move(right));
+    };
+    return rec(rec, first, last);
+}
+
+// Inclusive scan of [first, last) into out, seeded with init. Two passes:
+// per-chunk totals in parallel, a serial scan of the totals, then parallel fix-up.
+template<typename It, typename Out, typename T, typename Op>
+requires std::random_access_iterator<It> && std::random_access_iterator<Out>
+void parallelScan(It first, It last, std::size_t grain, Out out, T init, Op op, ThreadPool& pool = ThreadPool::global()) {
+    using Index = std::ptrdiff_t;
+    const Index n = last - first;
+    if (n <= 0) {
+        return;
+    }
+    const Index step = std::max<Index>(detail::autoGrain(n, grain, pool), 1);
+    const Index chunks = (n + step - 1) / step;
+
+    std::vector<T> totals(chunks);
+    parallelFor(Index{0}, chunks, 1, [&](Index lo, Index hi) {
+        for (Index c = lo; c < hi; ++c) {
+            const Index b = c * step, e = std::min(n, b + step);
+            T acc = first[b];
+            for (Index i = b + 1; i < e; ++i) {
+                acc = op(std::move(acc), first[i]);
+            }
+            totals[c] = std::move(acc);
+        }
+    }, pool);
+
+    T carry = std::move(init);
+    for (Index c = 0; c < chunks; ++c) {
+        T next = op(carry, totals[c]);
+        totals[c] = std::exchange(carry, std::move(next));
+    }
+
+    parallelFor(Index{0}, chunks, 1, [&](Index lo, Index hi) {
+        for (Index c = lo; c < hi; ++c) {
+            const Index b = c * step, e = std::min(n, b + step);
+            T acc = totals[c];
+            for (Index i = b; i < e; ++i) {
+                acc = op(std::move(acc), first[i]);
+                out[i] = acc;
+            }
+        }
+    }, pool);
+}
+
+}  // namespace scl
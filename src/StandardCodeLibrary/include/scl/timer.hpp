@@ -2,15 +2,22 @@
 
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <format>
+#include <functional>
+#include <utility>
 
 namespace scl {
 
 class Timer final {
 public:
-    explicit Timer(const std::string& title) {
+    // Receives each finished line; without one, lines go to std::cout.
+    using Sink = std::function<void(std::string_view)>;
+
+    explicit Timer(const std::string& title, Sink sink = nullptr) {
         title_ = title;
+        sink_ = std::move(sink);
 
         auto current_time = std::chrono::steady_clock::now();
         start_time_ = current_time;
@@ -20,7 +27,7 @@ class Timer final {
     ~Timer() {
         auto current_time = std::chrono::steady_clock::now();
         auto start_duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time_).count();
-        std::cout << std::format("[Timer: {}, Mark: total] Duration from start timestamp: {} ms.", title_, start_duration) << std::endl;
+        emit(std::format("[Timer: {}, Mark: total] Duration from start timestamp: {} ms.", title_, start_duration));
     }
 
     void timeStamp(const std::string& mark) {
@@ -28,15 +35,25 @@ class Timer final {
         auto last_duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_time_).count();
         auto start_duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time_).count();
         if (last_duration != start_duration) {
-            std::cout << std::format("[Timer: {}, Mark: {}] Duration from last timestamp: {} ms.", title_, mark, last_duration) << std::endl;
+            emit(std::format("[Timer: {}, Mark: {}] Duration from last timestamp: {} ms.", title_, mark, last_duration));
         }
-        std::cout << std::format("[Timer: {}, Mark: {}] Duration from start timestamp: {} ms.", title_, mark, start_duration) << std::endl;
+        emit(std::format("[Timer: {}, Mark: {}] Duration from start timestamp: {} ms.", title_, mark, start_duration));
 
         last_time_ = current_time;
     }
 
 private:
+    // '\n' rather than std::endl: flushing on every mark stalls the timed code.
+    void emit(const std::string& line) const {
+        if (sink_) {
+            sink_(line);
+        } else {
+            std::cout << line << '\n';
+        }
+    }
+
     std::string title_;
+    Sink sink_;
     std::chrono::steady_clock::time_point start_time_, last_time_;
 };
 
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include "scl/arena.hpp"
+#include "scl/rmq.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+bool aligned(const void* p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+void arena() {
+    scl::Arena arena(1024);
+    bool ok = true;
+    std::vector<unsigned char*> blocks;
+    for (std::size_t i = 0; i < 500; ++i) {
+        const std::size_t alignment = std::size_t{1} << (i % 7);
+        auto* p = static_cast<unsigned char*>(arena.allocate(i % 300 + 1, alignment));
+        ok &= aligned(p, alignment);
+        std::fill(p, p + i % 300 + 1, static_cast<unsigned char>(i));
+        blocks.push_back(p);
+    }
+    check(ok, "arena alignment");
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        ok &= std::all_of(blocks[i], blocks[i] + i % 300 + 1, [&](unsigned char c) { return c == static_cast<unsigned char>(i); });
+    }
+    check(ok, "arena blocks do not overlap");
+
+    // one big chunk after a reset, so the same workload needs no new chunk
+    const std::size_t reserved = arena.bytesReserved();
+    arena.reset();
+    check(arena.bytesAllocated() == 0 && arena.bytesReserved() == reserved, "arena reset keeps the memory");
+    for (std::size_t i = 0; i < 500; ++i) {
+        const std::size_t alignment = std::size_t{1} << (i % 7);
+        ok &= aligned(arena.allocate(i % 300 + 1, alignment), alignment);
+    }
+    check(ok, "arena alignment after reset");
+    check(arena.bytesReserved() == reserved, "arena reuses the coalesced chunk");
+
+    arena.release();
+    check(arena.bytesReserved() == 0, "arena release");
+}
+
+void pool() {
+    scl::PoolResource pool;
+    std::mt19937 rng(3);
+    std::vector<std::pmr::vector<int>> live;
+    bool ok = true;
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            std::pmr::vector<int> v(&pool);
+            const int n = static_cast<int>(rng() % 2000);
+            for (int i = 0; i < n; ++i) {
+                v.push_back(step + i);
+            }
+            live.push_back(std::move(v));
+        } else {
+            const std::size_t k = rng() % live.size();
+            const auto& v = live[k];
+            for (std::size_t i = 1; i < v.size(); ++i) {
+                ok &= v[i] == v[i - 1] + 1;
+            }
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(k));
+        }
+    }
+    check(ok, "pool blocks keep their contents");
+}
+
+void rmqOnArena() {
+    std::mt19937 rng(5);
+    std::vector<int> v(5000);
+    for (auto& x : v) {
+        x = static_cast<int>(rng() % 1000);
+    }
+    scl::Arena arena;
+    RMQ<int> rmq(v, &arena);
+    bool ok = true;
+    for (int q = 0; q < 20000; ++q) {
+        int l = static_cast<int>(rng() % v.size());
+        int r = static_cast<int>(rng() % v.size());
+        if (l > r) {
+            std::swap(l, r);
+        }
+        ++r;
+        ok &= rmq(l, r) == *std::min_element(v.begin() + l, v.begin() + r);
+    }
+    check(ok, "RMQ on an arena");
+    check(arena.bytesAllocated() > 0, "RMQ allocates from the arena");
+
+    const RMQ<int> copy(rmq);
+    check(copy.pre.get_allocator().resource() == std::pmr::get_default_resource(), "RMQ copies use the default resource");
+    const RMQ<int> moved(std::move(rmq));
+    check(moved.pre.get_allocator().resource() == &arena, "RMQ moves keep the arena");
+
+    const RMQ<int> braced({5, 3, 4});
+    check(braced(0, 3) == 3, "RMQ from a braced list");
+}
+
+}  // namespace
+
+int main() {
+    arena();
+    pool();
+    rmqOnArena();
+
+    return test::report("arena");
+}
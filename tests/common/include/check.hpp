@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <iostream>
+
+// Minimal harness for the test executables: check() records a failure and
+// carries on, so one run lists every broken case, and report() turns the
+// count into the exit code.
+namespace test {
+
+inline std::atomic<int> failures{0};
+
+// Any thread; the pool tests call it from inside parallel bodies.
+inline void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "FAILED: " << what << '\n';
+        failures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline int report(const char* name) {
+    if (failures.load() != 0) {
+        return 1;
+    }
+    std::cout << name << ": ok\n";
+    return 0;
+}
+
+}  // namespace test
@@ -0,0 +1,80 @@
+#include <bitset>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "scl/flagset.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+enum class Flag {};
+
+constexpr std::size_t N = 130;
+using Set = scl::FlagSet<Flag, N>;
+
+bool same(const Set& set, const std::bitset<N>& ref) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (set.contains(static_cast<Flag>(i)) != ref[i]) {
+            return false;
+        }
+    }
+    return set.count() == ref.count() && set.any() == ref.any() && set.all() == ref.all();
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<std::size_t> bit(0, N - 1);
+
+    Set a, b;
+    std::bitset<N> ra, rb;
+    for (int step = 0; step < 20000; ++step) {
+        const auto i = bit(rng);
+        const auto flag = static_cast<Flag>(i);
+        switch (rng() % 4) {
+        case 0: a.set(flag); ra.set(i); break;
+        case 1: a.reset(flag); ra.reset(i); break;
+        case 2: a.flip(flag); ra.flip(i); break;
+        default: b.flip(flag); rb.flip(i); break;
+        }
+        if (step % 97 == 0) {
+            check(same(a, ra), "set/reset/flip");
+            check(same(a | b, ra | rb), "operator|");
+            check(same(a & b, ra & rb), "operator&");
+            check(same(a ^ b, ra ^ rb), "operator^");
+            check(same(~a, ~ra), "operator~");
+            check(same(a.andNot(b), ra & ~rb), "andNot");
+            check(a.containsAll(a & b), "containsAll");
+            check(a.intersects(b) == (ra & rb).any(), "intersects");
+        }
+    }
+
+    std::vector<std::size_t> seen;
+    for (Flag flag : a) {
+        seen.push_back(static_cast<std::size_t>(flag));
+    }
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (ra[i]) {
+            expected.push_back(i);
+        }
+    }
+    check(seen == expected, "iteration order");
+
+    check(!Set{}.any() && Set{}.none(), "empty");
+    check((~Set{}).all() && (~Set{}).count() == N, "full");
+    check(Set{static_cast<Flag>(N - 1)} == (Set{} | static_cast<Flag>(N - 1)), "last bit");
+
+    std::vector<Set> sets{a, b, a | b, Set{}};
+    std::vector<std::size_t> out;
+    scl::filterAll(sets, a, out);
+    check(out == std::vector<std::size_t>{0, 2}, "filterAll");
+    check(scl::countAll(sets, Set{}) == sets.size(), "countAll");
+
+    return test::report("flagset");
+}
@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "scl/flathash.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+template<typename Map, typename Ref>
+bool same(const Map& map, const Ref& ref) {
+    if (map.size() != ref.size()) {
+        return false;
+    }
+    std::size_t visited = 0;
+    for (const auto& [key, value] : map) {
+        auto it = ref.find(key);
+        if (it == ref.end() || it->second != value) {
+            return false;
+        }
+        ++visited;
+    }
+    return visited == ref.size();
+}
+
+void randomOps() {
+    std::mt19937_64 rng(7);
+    scl::FlatHashMap<std::uint64_t, int> map;
+    std::unordered_map<std::uint64_t, int> ref;
+    bool ok = true;
+    for (int step = 0; step < 400000; ++step) {
+        // a small key range keeps hits, misses and tombstones all frequent
+        const std::uint64_t key = rng() % 5000;
+        switch (rng() % 5) {
+        case 0:
+        case 1: {
+            const bool inserted = map.tryEmplace(key, step).second;
+            ok &= inserted == ref.try_emplace(key, step).second;
+            break;
+        }
+        case 2:
+            map.insertOrAssign(key, step);
+            ref.insert_or_assign(key, step);
+            break;
+        case 3:
+            ok &= map.erase(key) == ref.erase(key);
+            break;
+        default: {
+            auto it = map.find(key);
+            auto rt = ref.find(key);
+            ok &= (it == map.end()) == (rt == ref.end());
+            if (it != map.end() && rt != ref.end()) {
+                ok &= it->second == rt->second;
+            }
+            ok &= map.contains(key) == ref.contains(key);
+            break;
+        }
+        }
+        if (step % 50000 == 0) {
+            check(same(map, ref), "map matches unordered_map");
+        }
+    }
+    check(ok, "random operations");
+    check(same(map, ref), "map matches unordered_map at the end");
+
+    // erase everything through iterators
+    for (auto it = map.begin(); it != map.end();) {
+        it = map.erase(it);
+    }
+    check(map.empty() && map.begin() == map.end(), "erase by iterator");
+}
+
+// Keys differing only above the low bits collide into the same groups and
+// tags, so probing and tombstone reuse are exercised on long chains.
+void collisions() {
+    scl::FlatHashSet<std::uint64_t, scl::IdentityHash> set;
+    std::unordered_set<std::uint64_t> ref;
+    for (int round = 0; round < 20; ++round) {
+        for (std::uint64_t i = 0; i < 2000; ++i) {
+            const std::uint64_t key = (i << 32) | static_cast<std::uint64_t>(round % 3);
+            set.insert(key);
+            ref.insert(key);
+        }
+        for (std::uint64_t i = round % 2; i < 2000; i += 2) {
+            const std::uint64_t key = (i << 32) | static_cast<std::uint64_t>(round % 3);
+            check(set.erase(key) == ref.erase(key), "colliding erase");
+        }
+    }
+    bool ok = set.size() == ref.size();
+    for (const auto key : ref) {
+        ok &= set.contains(key);
+    }
+    check(ok, "colliding keys");
+}
+
+void valueSemantics() {
+    scl::FlatHashMap<std::string, std::string> map;
+    for (int i = 0; i < 1000; ++i) {
+        map[std::to_string(i)] = std::string(i % 50, 'x');
+    }
+    auto copy = map;
+    check(copy.size() == 1000 && copy.at("999") == std::string(999 % 50, 'x'), "copy");
+    copy.erase("5");
+    check(map.contains("5") && !copy.contains("5"), "copies are independent");
+
+    auto moved = std::move(copy);
+    check(moved.size() == 999 && moved.at("998").size() == 998 % 50, "move");
+
+    bool threw = false;
+    try {
+        static_cast<void>(moved.at("nope"));
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    check(threw, "at throws on a missing key");
+
+    map.clear();
+    check(map.empty() && !map.contains("1"), "clear");
+    map.reserve(10000);
+    const std::size_t capacity = map.capacity();
+    for (int i = 0; i < 10000; ++i) {
+        map[std::to_string(i)];
+    }
+    check(map.capacity() == capacity, "reserve avoids rehash");
+}
+
+}  // namespace
+
+int main() {
+    randomOps();
+    collisions();
+    valueSemantics();
+
+    return test::report("flathash");
+}
@@ -0,0 +1,287 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "scl/ringqueue.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+// The blocking calls hang rather than fail, so each case runs under a deadline.
+template<typename F>
+void withDeadline(const char* what, F&& f) {
+    auto done = std::async(std::launch::async, std::forward<F>(f));
+    if (done.wait_for(std::chrono::seconds(60)) != std::future_status::ready) {
+        std::cerr << "FAILED: " << what << " did not finish\n";
+        std::_Exit(1);
+    }
+    done.get();
+}
+
+std::atomic<int> live{0};
+
+// Counts live instances; moving can be made slow to widen the window between
+// a producer claiming a cell and publishing it.
+struct Item {
+    std::int64_t value = -1;
+    bool slow = false;
+
+    Item() {
+        live.fetch_add(1, std::memory_order_relaxed);
+    }
+    Item(std::int64_t v, bool s) : value(v), slow(s) {
+        live.fetch_add(1, std::memory_order_relaxed);
+    }
+    Item(Item&& other) noexcept : value(other.value), slow(other.slow) {
+        if (slow) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        live.fetch_add(1, std::memory_order_relaxed);
+    }
+    Item(const Item& other) : value(other.value), slow(other.slow) {
+        live.fetch_add(1, std::memory_order_relaxed);
+    }
+    Item& operator=(Item&& other) noexcept {
+        value = other.value;
+        slow = other.slow;
+        return *this;
+    }
+    Item& operator=(const Item&) = default;
+    ~Item() {
+        live.fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+
+void spscBlocking() {
+    constexpr std::int64_t n = 200'000;
+    scl::SpscQueue<std::int64_t> queue(4);
+    std::thread producer([&] {
+        for (std::int64_t i = 0; i < n; ++i) {
+            queue.push(i);
+        }
+    });
+    bool ordered = true;
+    for (std::int64_t i = 0; i < n; ++i) {
+        ordered &= queue.pop() == i;
+    }
+    producer.join();
+    check(ordered, "spsc blocking push/pop keeps order");
+    check(queue.sizeApprox() == 0, "spsc drained");
+}
+
+void spscBatch() {
+    constexpr std::int64_t n = 200'000;
+    scl::SpscQueue<std::int64_t> queue(64);
+    std::thread producer([&] {
+        std::vector<std::int64_t> chunk;
+        for (std::int64_t next = 0; next < n;) {
+            chunk.clear();
+            for (; next < n && chunk.size() < 37; ++next) {
+                chunk.push_back(next);
+            }
+            for (auto it = chunk.begin(); it != chunk.end(); std::this_thread::yield()) {
+                it = queue.tryPushBatch(it, chunk.end());
+            }
+        }
+    });
+    std::vector<std::int64_t> got;
+    std::int64_t buffer[16];
+    while (static_cast<std::int64_t>(got.size()) < n) {
+        const std::size_t k = queue.tryPopBatch(buffer, 16);
+        got.insert(got.end(), buffer, buffer + k);
+        if (k == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    bool ordered = true;
+    for (std::int64_t i = 0; i < n; ++i) {
+        ordered &= got[i] == i;
+    }
+    check(ordered, "spsc batches keep order");
+}
+
+void mpmcBlocking() {
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr std::int64_t perProducer = 50'000;
+    scl::MpmcQueue<std::int64_t> queue(8);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (std::int64_t i = 0; i < perProducer; ++i) {
+                queue.push(p * perProducer + i);
+            }
+        });
+    }
+    std::vector<std::vector<std::int64_t>> seen(consumers);
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            for (std::int64_t i = 0; i < perProducer * producers / consumers; ++i) {
+                seen[c].push_back(queue.pop());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::vector<int> count(producers * perProducer, 0);
+    bool fifo = true;
+    for (const auto& values : seen) {
+        std::vector<std::int64_t> last(producers, -1);
+        for (const std::int64_t v : values) {
+            ++count[v];
+            fifo &= v > last[v / perProducer];
+            last[v / perProducer] = v;
+        }
+    }
+    bool once = true;
+    for (const int k : count) {
+        once &= k == 1;
+    }
+    check(once, "mpmc delivers every element once");
+    check(fifo, "mpmc keeps each producer's order");
+}
+
+// A consumer that starts waiting after a producer claimed a cell but before
+// it published it must still be woken by that publish.
+void mpmcSlowPublish() {
+    constexpr int rounds = 200;
+    scl::MpmcQueue<Item> queue(4);
+    std::thread consumer([&] {
+        for (int i = 0; i < rounds; ++i) {
+            const Item item = queue.pop();
+            check(item.value == i, "mpmc slow publish order");
+        }
+    });
+    for (int i = 0; i < rounds; ++i) {
+        if (i % 3 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(300));
+        }
+        queue.push(Item(i, true));
+    }
+    consumer.join();
+}
+
+void mpmcBatchAndDestroy() {
+    {
+        scl::MpmcQueue<Item> queue(16);
+        std::vector<Item> items;
+        for (int i = 0; i < 20; ++i) {
+            items.emplace_back(i, false);
+        }
+        const auto rest = queue.tryPushBatch(items.begin(), items.end());
+        check(rest - items.begin() == 16, "mpmc batch push stops when full");
+        check(!queue.tryPush(Item(99, false)), "mpmc full");
+
+        std::vector<Item> out(5);
+        check(queue.tryPopBatch(out.begin(), 5) == 5 && out[4].value == 4, "mpmc batch pop");
+    }
+    // the queue destroyed the 11 it still held
+    check(live.load() == 0, "mpmc destroys what is left");
+}
+
+// No default constructor and no copies: the queues must not need either.
+struct MoveOnly {
+    std::unique_ptr<int> value;
+
+    explicit MoveOnly(int v) : value(std::make_unique<int>(v)) {}
+};
+
+template<typename Queue>
+void moveOnly(Queue& queue) {
+    queue.push(MoveOnly(1));
+    check(queue.tryEmplace(2) && queue.tryPush(MoveOnly(3)), "move-only push");
+    check(*queue.pop().value == 1, "move-only pop");
+    MoveOnly out(0);
+    check(queue.tryPop(out) && *out.value == 2, "move-only tryPop");
+    std::vector<MoveOnly> rest;
+    check(queue.tryPopBatch(std::back_inserter(rest), 4) == 1 && *rest[0].value == 3, "move-only batch pop");
+    queue.push(MoveOnly(4));
+    // the rest is destroyed in place by the queue
+}
+
+void moveOnlyTypes() {
+    scl::SpscQueue<MoveOnly> spsc(4);
+    moveOnly(spsc);
+    scl::MpmcQueue<MoveOnly> mpmc(4);
+    moveOnly(mpmc);
+}
+
+// Copies throw on request and so does move assignment; moves construct
+// without throwing.
+struct Fragile {
+    static inline bool failCopy = false;
+    static inline bool failAssign = false;
+    int value = 0;
+
+    explicit Fragile(int v) : value(v) {}
+    Fragile(const Fragile& other) : value(other.value) {
+        if (failCopy) {
+            throw std::runtime_error("copy");
+        }
+    }
+    Fragile(Fragile&& other) noexcept : value(other.value) {}
+    Fragile& operator=(Fragile&& other) {
+        if (failAssign) {
+            throw std::runtime_error("assign");
+        }
+        value = other.value;
+        return *this;
+    }
+};
+
+bool throws(auto&& f) {
+    try {
+        f();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// A throwing copy must not leave a claimed cell unpublished, nor a throwing
+// consumer leave one unreleased; either would hang the next pop or push.
+void throwingValues() {
+    scl::MpmcQueue<Fragile> queue(2);
+    const Fragile one(1);
+    Fragile::failCopy = true;
+    check(throws([&] { queue.tryPush(one); }), "throwing copy propagates");
+    Fragile::failCopy = false;
+    check(queue.tryPush(one) && queue.tryPush(Fragile(2)), "push after a throwing copy");
+    check(queue.pop().value == 1, "pop after a throwing copy");
+
+    Fragile out(0);
+    Fragile::failAssign = true;
+    check(throws([&] { queue.tryPop(out); }), "throwing consumer propagates");
+    Fragile::failAssign = false;
+    check(queue.tryPush(Fragile(3)) && queue.tryPush(Fragile(4)), "the thrown-on cell was released");
+    check(queue.pop().value == 3 && queue.pop().value == 4, "pop after a throwing consumer");
+}
+
+}  // namespace
+
+int main() {
+    withDeadline("spsc blocking", spscBlocking);
+    withDeadline("spsc batch", spscBatch);
+    withDeadline("mpmc blocking", mpmcBlocking);
+    withDeadline("mpmc slow publish", mpmcSlowPublish);
+    withDeadline("mpmc batch", mpmcBatchAndDestroy);
+    withDeadline("move-only types", moveOnlyTypes);
+    withDeadline("throwing values", throwingValues);
+
+    return test::report("ringqueue");
+}
@@ -0,0 +1,150 @@
+// SpscQueue and MpmcQueue against the mutex + std::deque + condition_variable
+// queue they replace. Throughput moves `items` 64-bit values through the
+// queue with blocking push/pop for several producer/consumer counts; latency
+// is the round trip of a ping-pong over two queues, reported as percentiles.
+// Usage: ringqueue_bench [max threads per side]
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "scl/ringqueue.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class MutexQueue {
+public:
+    explicit MutexQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    void push(std::int64_t value) {
+        std::unique_lock lock(mutex_);
+        notFull_.wait(lock, [&] { return items_.size() < capacity_; });
+        items_.push_back(value);
+        lock.unlock();
+        notEmpty_.notify_one();
+    }
+
+    std::int64_t pop() {
+        std::unique_lock lock(mutex_);
+        notEmpty_.wait(lock, [&] { return !items_.empty(); });
+        const std::int64_t value = items_.front();
+        items_.pop_front();
+        lock.unlock();
+        notFull_.notify_one();
+        return value;
+    }
+
+private:
+    std::size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<std::int64_t> items_;
+};
+
+constexpr std::size_t capacity = 1024;
+
+template<typename Queue>
+double throughput(int producers, int consumers, std::int64_t items) {
+    Queue queue(capacity);
+    const std::int64_t perProducer = items / producers;
+    const std::int64_t total = perProducer * producers;
+    std::vector<std::thread> threads;
+    std::vector<std::int64_t> sums(consumers, 0);
+
+    const auto start = Clock::now();
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (std::int64_t i = 0; i < perProducer; ++i) {
+                queue.push(i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        // the last consumer takes the remainder
+        const std::int64_t share = total / consumers + (c == consumers - 1 ? total % consumers : 0);
+        threads.emplace_back([&, c, share] {
+            for (std::int64_t i = 0; i < share; ++i) {
+                sums[c] += queue.pop();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return static_cast<double>(total) / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Percentiles {
+    double p50, p99, p999;
+};
+
+template<typename Queue>
+Percentiles roundTrip(int rounds) {
+    Queue ping(capacity), pong(capacity);
+    std::thread echo([&] {
+        for (int i = 0; i < rounds; ++i) {
+            pong.push(ping.pop());
+        }
+    });
+    std::vector<double> ns(rounds);
+    for (int i = 0; i < rounds; ++i) {
+        const auto start = Clock::now();
+        ping.push(i);
+        pong.pop();
+        ns[i] = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+    echo.join();
+    std::ranges::sort(ns);
+    auto at = [&](double q) {
+        return ns[std::min<std::size_t>(ns.size() - 1, static_cast<std::size_t>(q * ns.size()))];
+    };
+    return {at(0.5), at(0.99), at(0.999)};
+}
+
+void printThroughput(const std::string& name, double perSecond) {
+    std::cout << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << perSecond / 1e6 << " M items/s\n";
+}
+
+void printLatency(const std::string& name, const Percentiles& p) {
+    std::cout << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(0)
+              << "p50 " << std::setw(8) << p.p50 << " ns  p99 " << std::setw(8) << p.p99
+              << " ns  p99.9 " << std::setw(8) << p.p999 << " ns\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int maxSide = argc > 1 ? std::atoi(argv[1]) : std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+    constexpr std::int64_t items = 4'000'000;
+
+    std::cout << "throughput, 1 producer / 1 consumer, capacity " << capacity << '\n';
+    printThroughput("mutex", throughput<MutexQueue>(1, 1, items));
+    printThroughput("spsc", throughput<scl::SpscQueue<std::int64_t>>(1, 1, items));
+    printThroughput("mpmc", throughput<scl::MpmcQueue<std::int64_t>>(1, 1, items));
+
+    for (int side = 2; side <= maxSide; side *= 2) {
+        std::cout << "throughput, " << side << " producers / " << side << " consumers\n";
+        printThroughput("mutex", throughput<MutexQueue>(side, side, items));
+        printThroughput("mpmc", throughput<scl::MpmcQueue<std::int64_t>>(side, side, items));
+    }
+
+    constexpr int rounds = 200'000;
+    std::cout << "round trip latency, " << rounds << " ping-pongs\n";
+    printLatency("mutex", roundTrip<MutexQueue>(rounds));
+    printLatency("spsc", roundTrip<scl::SpscQueue<std::int64_t>>(rounds));
+    printLatency("mpmc", roundTrip<scl::MpmcQueue<std::int64_t>>(rounds));
+    return 0;
+}
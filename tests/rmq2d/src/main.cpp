@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "scl/rmq2d.hpp"
+#include "scl/threadpool.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+struct Rect {
+    int r1, r2, c1, c2;
+};
+
+// Non-empty when `nonEmpty`, otherwise either range may be empty.
+Rect randomRect(std::mt19937& rng, int rows, int cols, bool nonEmpty) {
+    auto range = [&](int n) {
+        int a = static_cast<int>(rng() % (n + 1));
+        int b = static_cast<int>(rng() % (n + 1));
+        if (a > b) {
+            std::swap(a, b);
+        }
+        if (nonEmpty && a == b) {
+            a == n ? --a : ++b;
+        }
+        return std::pair{a, b};
+    };
+    const auto [r1, r2] = range(rows);
+    const auto [c1, c2] = range(cols);
+    return {r1, r2, c1, c2};
+}
+
+template<class Cmp>
+void rmq2d(const std::vector<int>& data, int rows, int cols, scl::ThreadPool& pool, std::mt19937& rng) {
+    const scl::RMQ2D<int, Cmp> rmq(data, rows, cols, pool);
+    check(rmq.rows() == rows && rmq.cols() == cols, "RMQ2D shape");
+    bool ok = true;
+    for (int q = 0; q < 3000; ++q) {
+        const Rect rect = randomRect(rng, rows, cols, true);
+        int expected = data[static_cast<std::size_t>(rect.r1) * cols + rect.c1];
+        for (int r = rect.r1; r < rect.r2; ++r) {
+            for (int c = rect.c1; c < rect.c2; ++c) {
+                expected = std::min(expected, data[static_cast<std::size_t>(r) * cols + c], Cmp{});
+            }
+        }
+        ok &= rmq(rect.r1, rect.r2, rect.c1, rect.c2) == expected;
+    }
+    check(ok, "RMQ2D matches brute force");
+}
+
+// The structure has to fit next to its matrix at heatmap sizes, so the
+// overhead must stay a fraction of the data as the matrix grows.
+void rmq2dMemory(scl::ThreadPool& pool) {
+    for (const int side : {256, 1024, 4096}) {
+        const std::vector<float> data(static_cast<std::size_t>(side) * side, 1.0f);
+        const scl::RMQ2D<float> rmq(data, side, side, pool);
+        const std::size_t matrix = data.size() * sizeof(float);
+        check(rmq.bytes() < 2 * matrix, "RMQ2D stays under twice its matrix");
+        check(rmq(0, side, 0, side) == 1.0f, "RMQ2D over the whole matrix");
+    }
+}
+
+void prefixSum(const std::vector<int>& data, int rows, int cols, scl::ThreadPool& pool, std::mt19937& rng) {
+    const scl::PrefixSum2D<int, std::int64_t> sums(data, rows, cols, pool);
+    std::vector<float> floats(data.begin(), data.end());
+    const scl::PrefixSum2D<float, double> floatSums(floats, rows, cols, pool);
+    bool ok = true;
+    for (int q = 0; q < 3000; ++q) {
+        const Rect rect = randomRect(rng, rows, cols, false);
+        std::int64_t expected = 0;
+        for (int r = rect.r1; r < rect.r2; ++r) {
+            for (int c = rect.c1; c < rect.c2; ++c) {
+                expected += data[static_cast<std::size_t>(r) * cols + c];
+            }
+        }
+        ok &= sums(rect.r1, rect.r2, rect.c1, rect.c2) == expected;
+        ok &= std::abs(floatSums(rect.r1, rect.r2, rect.c1, rect.c2) - static_cast<double>(expected)) < 1e-6;
+    }
+    check(ok, "PrefixSum2D matches brute force");
+}
+
+void run(scl::ThreadPool& pool) {
+    std::mt19937 rng(7);
+    // shapes around RMQ2D's row and column blocks and PrefixSum2D's column strip
+    const std::pair<int, int> shapes[] = {
+        {1, 1}, {1, 300}, {300, 1}, {16, 16}, {17, 5}, {33, 70}, {64, 9}, {129, 257}, {250, 300}, {40, 1100},
+    };
+    for (const auto& [rows, cols] : shapes) {
+        std::vector<int> data(static_cast<std::size_t>(rows) * cols);
+        for (auto& x : data) {
+            x = static_cast<int>(rng() % 2001) - 1000;
+        }
+        rmq2d<std::less<int>>(data, rows, cols, pool, rng);
+        rmq2d<std::greater<int>>(data, rows, cols, pool, rng);
+        prefixSum(data, rows, cols, pool, rng);
+    }
+
+    rmq2dMemory(pool);
+
+    const scl::RMQ2D<int> empty(std::vector<int>{}, 0, 0, pool);
+    check(empty.rows() == 0 && empty.cols() == 0, "RMQ2D of an empty matrix");
+    const scl::PrefixSum2D<int> emptySums(std::vector<int>{}, 0, 0, pool);
+    check(emptySums(0, 0, 0, 0) == 0, "PrefixSum2D of an empty matrix");
+}
+
+}  // namespace
+
+int main() {
+    scl::ThreadPool pool(4);
+    run(pool);
+    scl::ThreadPool empty(0);
+    run(empty);
+
+    return test::report("rmq2d");
+}
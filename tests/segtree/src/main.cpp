@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "scl/fenwick.hpp"
+#include "scl/segtree.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+using Tag = scl::AddAssignTag<std::int64_t>;
+
+std::pair<int, int> randomRange(std::mt19937& rng, int n) {
+    int l = static_cast<int>(rng() % (n + 1));
+    int r = static_cast<int>(rng() % (n + 1));
+    if (l > r) {
+        std::swap(l, r);
+    }
+    return {l, r};
+}
+
+void lazySegmentTree(int n, std::mt19937& rng) {
+    std::vector<std::int64_t> ref(n);
+    for (auto& x : ref) {
+        x = static_cast<std::int64_t>(rng() % 1000);
+    }
+    scl::LazySegmentTree<scl::SumInfo<std::int64_t>, Tag> sum(std::vector<scl::SumInfo<std::int64_t>>(ref.begin(), ref.end()));
+    scl::LazySegmentTree<scl::MinInfo<std::int64_t>, Tag> min(std::vector<scl::MinInfo<std::int64_t>>(ref.begin(), ref.end()));
+    scl::LazySegmentTree<scl::MaxInfo<std::int64_t>, Tag> max(std::vector<scl::MaxInfo<std::int64_t>>(ref.begin(), ref.end()));
+    check(sum.size() == n, "LazySegmentTree size");
+
+    bool ok = true;
+    for (int op = 0; op < 4000; ++op) {
+        const auto [l, r] = randomRange(rng, n);
+        const std::int64_t v = static_cast<std::int64_t>(rng() % 2001) - 1000;
+        switch (rng() % 6) {
+        case 0: {
+            const Tag tag = Tag::makeAdd(v);
+            sum.apply(l, r, tag);
+            min.apply(l, r, tag);
+            max.apply(l, r, tag);
+            for (int i = l; i < r; ++i) {
+                ref[i] += v;
+            }
+            break;
+        }
+        case 1: {
+            const Tag tag = Tag::makeAssign(v);
+            sum.apply(l, r, tag);
+            min.apply(l, r, tag);
+            max.apply(l, r, tag);
+            std::fill(ref.begin() + l, ref.begin() + r, v);
+            break;
+        }
+        case 2: {
+            const int p = static_cast<int>(rng() % n);
+            sum.set(p, v);
+            min.set(p, v);
+            max.set(p, v);
+            ref[p] = v;
+            break;
+        }
+        case 3: {
+            const int p = static_cast<int>(rng() % n);
+            sum.apply(p, Tag::makeAdd(v));
+            min.apply(p, Tag::makeAdd(v));
+            max.apply(p, Tag::makeAdd(v));
+            ref[p] += v;
+            ok &= sum.get(p).sum == ref[p] && min.get(p).min == ref[p] && max.get(p).max == ref[p];
+            break;
+        }
+        default: {
+            ok &= sum.query(l, r).sum == std::accumulate(ref.begin() + l, ref.begin() + r, std::int64_t{0});
+            if (l < r) {
+                ok &= min.query(l, r).min == *std::min_element(ref.begin() + l, ref.begin() + r);
+                ok &= max.query(l, r).max == *std::max_element(ref.begin() + l, ref.begin() + r);
+            }
+            break;
+        }
+        }
+    }
+    check(ok, "LazySegmentTree matches brute force");
+    check(sum.all().sum == std::accumulate(ref.begin(), ref.end(), std::int64_t{0}), "LazySegmentTree all");
+    check(sum.query(0, 0).len == 0, "LazySegmentTree empty query is the identity");
+
+    scl::LazySegmentTree<scl::SumInfo<std::int64_t>, Tag> filled(n, scl::SumInfo<std::int64_t>(3));
+    filled.apply(0, n, Tag::makeAdd(2));
+    check(filled.all().sum == 5 * static_cast<std::int64_t>(n) && filled.all().len == n, "LazySegmentTree fill constructor");
+}
+
+void fenwick(int n, std::mt19937& rng) {
+    std::vector<std::int64_t> ref(n);
+    for (auto& x : ref) {
+        x = static_cast<std::int64_t>(rng() % 10);
+    }
+    scl::Fenwick<std::int64_t> tree{std::span<const std::int64_t>(ref)};
+    scl::Fenwick<std::int64_t> empty(n);
+    check(tree.size() == n && empty.sum(n) == 0, "Fenwick size");
+
+    bool ok = true;
+    for (int op = 0; op < 4000; ++op) {
+        const auto [l, r] = randomRange(rng, n);
+        switch (rng() % 3) {
+        case 0: {
+            // non-negative elements keep lowerBound meaningful
+            const int p = static_cast<int>(rng() % n);
+            const auto v = static_cast<std::int64_t>(rng() % 10);
+            tree.add(p, v);
+            ref[p] += v;
+            break;
+        }
+        case 1:
+            ok &= tree.rangeSum(l, r) == std::accumulate(ref.begin() + l, ref.begin() + r, std::int64_t{0});
+            break;
+        default: {
+            const std::int64_t total = std::accumulate(ref.begin(), ref.end(), std::int64_t{0});
+            const auto k = static_cast<std::int64_t>(rng() % static_cast<std::uint64_t>(total + 2));
+            int expected = 0;
+            for (std::int64_t acc = 0; expected < n && acc + ref[expected] < k; ++expected) {
+                acc += ref[expected];
+            }
+            ok &= tree.lowerBound(k) == expected;
+            break;
+        }
+        }
+    }
+    check(ok, "Fenwick matches brute force");
+}
+
+void rangeFenwick(int n, std::mt19937& rng) {
+    std::vector<std::int64_t> ref(n);
+    scl::RangeFenwick<std::int64_t> tree(n);
+    check(tree.size() == n, "RangeFenwick size");
+
+    bool ok = true;
+    for (int op = 0; op < 4000; ++op) {
+        const auto [l, r] = randomRange(rng, n);
+        if (rng() % 2 == 0) {
+            const std::int64_t v = static_cast<std::int64_t>(rng() % 2001) - 1000;
+            tree.add(l, r, v);
+            for (int i = l; i < r; ++i) {
+                ref[i] += v;
+            }
+        } else {
+            ok &= tree.rangeSum(l, r) == std::accumulate(ref.begin() + l, ref.begin() + r, std::int64_t{0});
+        }
+    }
+    check(ok, "RangeFenwick matches brute force");
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(11);
+    for (const int n : {1, 2, 3, 7, 64, 65, 1000}) {
+        lazySegmentTree(n, rng);
+        fenwick(n, rng);
+        rangeFenwick(n, rng);
+    }
+
+    return test::report("segtree");
+}
@@ -0,0 +1,202 @@
+// LazySegmentTree (implicit heap layout, bottom-up, no recursion) against a
+// textbook recursive tree of heap-allocated nodes, both doing range add,
+// range assign and range sum over int64. Build time, then ns per operation
+// for updates and for queries. n = argv[1] (default 10^7), operations =
+// argv[2] (default 10^6).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "scl/segtree.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Tag = scl::AddAssignTag<std::int64_t>;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// One node per segment, children behind owning pointers, pushed down on the
+// way through: the layout most tutorials start from.
+class PointerTree {
+public:
+    explicit PointerTree(const std::vector<std::int64_t>& init) : n_(static_cast<int>(init.size())) {
+        root_ = build(init, 0, n_);
+    }
+
+    void apply(int l, int r, const Tag& t) {
+        apply(root_.get(), 0, n_, l, r, t);
+    }
+
+    std::int64_t query(int l, int r) {
+        return query(root_.get(), 0, n_, l, r);
+    }
+
+private:
+    struct Node {
+        std::int64_t sum{};
+        Tag tag;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+    };
+
+    static std::unique_ptr<Node> build(const std::vector<std::int64_t>& init, int lo, int hi) {
+        auto node = std::make_unique<Node>();
+        if (hi - lo == 1) {
+            node->sum = init[lo];
+            return node;
+        }
+        const int mid = lo + (hi - lo) / 2;
+        node->left = build(init, lo, mid);
+        node->right = build(init, mid, hi);
+        node->sum = node->left->sum + node->right->sum;
+        return node;
+    }
+
+    static void applyNode(Node* node, int len, const Tag& t) {
+        if (t.assign) {
+            node->sum = t.value * len;
+        }
+        node->sum += t.add * len;
+        node->tag.apply(t);
+    }
+
+    static void push(Node* node, int lo, int mid, int hi) {
+        applyNode(node->left.get(), mid - lo, node->tag);
+        applyNode(node->right.get(), hi - mid, node->tag);
+        node->tag = Tag{};
+    }
+
+    void apply(Node* node, int lo, int hi, int l, int r, const Tag& t) {
+        if (r <= lo || hi <= l) {
+            return;
+        }
+        if (l <= lo && hi <= r) {
+            applyNode(node, hi - lo, t);
+            return;
+        }
+        const int mid = lo + (hi - lo) / 2;
+        push(node, lo, mid, hi);
+        apply(node->left.get(), lo, mid, l, r, t);
+        apply(node->right.get(), mid, hi, l, r, t);
+        node->sum = node->left->sum + node->right->sum;
+    }
+
+    std::int64_t query(Node* node, int lo, int hi, int l, int r) {
+        if (r <= lo || hi <= l) {
+            return 0;
+        }
+        if (l <= lo && hi <= r) {
+            return node->sum;
+        }
+        const int mid = lo + (hi - lo) / 2;
+        push(node, lo, mid, hi);
+        return query(node->left.get(), lo, mid, l, r) + query(node->right.get(), mid, hi, l, r);
+    }
+
+    int n_;
+    std::unique_ptr<Node> root_;
+};
+
+struct Op {
+    int l, r;
+    Tag tag;
+};
+
+struct Result {
+    double buildSeconds;
+    double updateSeconds;
+    double querySeconds;
+    std::int64_t checksum;
+};
+
+template<class Tree, class Make, class Query>
+Result run(const std::vector<std::int64_t>& init, const std::vector<Op>& updates, const std::vector<Op>& queries, Make make, Query sum) {
+    Result result{};
+    auto start = Clock::now();
+    Tree tree = make(init);
+    result.buildSeconds = secondsSince(start);
+
+    start = Clock::now();
+    for (const Op& op : updates) {
+        tree.apply(op.l, op.r, op.tag);
+    }
+    result.updateSeconds = secondsSince(start);
+
+    start = Clock::now();
+    for (const Op& op : queries) {
+        result.checksum += sum(tree, op.l, op.r);
+    }
+    result.querySeconds = secondsSince(start);
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int n = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10'000'000;
+    const int ops = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1'000'000;
+
+    std::mt19937 rng(5);
+    std::vector<std::int64_t> init(n);
+    for (auto& x : init) {
+        x = static_cast<std::int64_t>(rng() % 1000);
+    }
+    auto randomOp = [&] {
+        int l = static_cast<int>(rng() % n);
+        int r = static_cast<int>(rng() % n);
+        if (l > r) {
+            std::swap(l, r);
+        }
+        const std::int64_t v = static_cast<std::int64_t>(rng() % 201) - 100;
+        // one assign in eight, the rest adds
+        return Op{l, r + 1, rng() % 8 == 0 ? Tag::makeAssign(v) : Tag::makeAdd(v)};
+    };
+    std::vector<Op> updates(ops), queries(ops);
+    std::ranges::generate(updates, randomOp);
+    std::ranges::generate(queries, randomOp);
+
+    using Flat = scl::LazySegmentTree<scl::SumInfo<std::int64_t>, Tag>;
+    const Result flat = run<Flat>(init, updates, queries,
+        [](const std::vector<std::int64_t>& v) {
+            return Flat(std::vector<scl::SumInfo<std::int64_t>>(v.begin(), v.end()));
+        },
+        [](Flat& tree, int l, int r) {
+            return tree.query(l, r).sum;
+        });
+    const Result pointer = run<PointerTree>(init, updates, queries,
+        [](const std::vector<std::int64_t>& v) {
+            return PointerTree(v);
+        },
+        [](PointerTree& tree, int l, int r) {
+            return tree.query(l, r);
+        });
+
+    std::cout << "n = " << n << ", " << ops << " updates then " << ops << " queries\n\n";
+    std::cout << std::left << std::setw(12) << "" << std::right << std::setw(12) << "build ms" << std::setw(14) << "update ns/op"
+              << std::setw(14) << "query ns/op" << '\n';
+    auto row = [&](const char* name, const Result& r) {
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(1) << std::setw(12)
+                  << r.buildSeconds * 1e3 << std::setw(14) << r.updateSeconds * 1e9 / ops << std::setw(14) << r.querySeconds * 1e9 / ops
+                  << '\n';
+    };
+    row("flat", flat);
+    row("pointer", pointer);
+    std::cout << std::setprecision(2) << "\nspeedup: build " << pointer.buildSeconds / flat.buildSeconds << "x, update "
+              << pointer.updateSeconds / flat.updateSeconds << "x, query " << pointer.querySeconds / flat.querySeconds << "x\n";
+
+    if (flat.checksum != pointer.checksum) {
+        std::cerr << "checksum mismatch: " << flat.checksum << " vs " << pointer.checksum << '\n';
+        return 1;
+    }
+    return 0;
+}
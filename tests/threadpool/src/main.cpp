@@ -0,0 +1,88 @@
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "scl/threadpool.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+void run(scl::ThreadPool& pool) {
+    constexpr int n = 1'000'003;
+
+    // every index visited exactly once, for automatic and explicit grains
+    for (const std::size_t grain : {std::size_t{0}, std::size_t{1}, std::size_t{777}, std::size_t{n}}) {
+        std::vector<std::atomic<int>> hits(n);
+        scl::parallelFor(0, n, grain, [&](int lo, int hi) {
+            check(grain == 0 || hi - lo <= static_cast<int>(grain), "parallelFor grain");
+            for (int i = lo; i < hi; ++i) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, pool);
+        bool once = true;
+        for (const auto& h : hits) {
+            once &= h.load() == 1;
+        }
+        check(once, "parallelFor covers the range once");
+    }
+
+    std::vector<std::int64_t> data(n);
+    std::iota(data.begin(), data.end(), std::int64_t{-500'000});
+    const std::int64_t expected = std::accumulate(data.begin(), data.end(), std::int64_t{0});
+    const std::int64_t sum = scl::parallelReduce(0, n, 0, std::int64_t{0}, [&](int lo, int hi) {
+        return std::accumulate(data.begin() + lo, data.begin() + hi, std::int64_t{0});
+    }, std::plus<>{}, pool);
+    check(sum == expected, "parallelReduce");
+
+    std::vector<std::int64_t> scanned(n), reference(n);
+    std::inclusive_scan(data.begin(), data.end(), reference.begin(), std::plus<>{}, std::int64_t{7});
+    for (const std::size_t grain : {std::size_t{0}, std::size_t{1000}}) {
+        scl::parallelScan(data.begin(), data.end(), grain, scanned.begin(), std::int64_t{7}, std::plus<>{}, pool);
+        check(scanned == reference, "parallelScan");
+    }
+
+    // nested loops must not deadlock: the waiting caller helps
+    std::atomic<std::int64_t> nested{0};
+    scl::parallelFor(0, 64, 1, [&](int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            scl::parallelFor(0, 1000, 10, [&](int a, int b) {
+                nested.fetch_add(b - a, std::memory_order_relaxed);
+            }, pool);
+        }
+    }, pool);
+    check(nested.load() == 64 * 1000, "nested parallelFor");
+
+    bool caught = false;
+    try {
+        scl::parallelFor(0, 1000, 1, [](int lo, int) {
+            if (lo == 500) {
+                throw std::runtime_error("boom");
+            }
+        }, pool);
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    check(caught, "exceptions propagate to the caller");
+}
+
+}  // namespace
+
+int main() {
+    scl::ThreadPool pool(4);
+    run(pool);
+
+    scl::ThreadPool pinned(2, true);
+    run(pinned);
+
+    // no workers: the calling thread does everything while it waits
+    scl::ThreadPool empty(0);
+    run(empty);
+
+    return test::report("threadpool");
+}
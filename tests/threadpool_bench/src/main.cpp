@@ -0,0 +1,106 @@
+// Speedup of parallelFor / parallelReduce / parallelScan over worker counts
+// 1, 2, 4, ... up to the core count (or argv[1]). Each figure is the best of
+// a few runs; speedup and efficiency are against the one-worker pool.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "scl/threadpool.hpp"
+
+namespace {
+
+template<typename F>
+double bestSeconds(int runs, F&& f) {
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+// ~100 ns of arithmetic per element, no memory traffic
+double work(std::int64_t i) {
+    double x = static_cast<double>(i);
+    for (int k = 0; k < 32; ++k) {
+        x = std::sqrt(x * 1.000001 + 3.0);
+    }
+    return x;
+}
+
+struct Row {
+    std::string name;
+    std::vector<double> seconds;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const unsigned maxThreads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(maxThreads);
+
+    constexpr std::int64_t computeN = 1 << 22;
+    constexpr std::int64_t memoryN = 1 << 26;
+    std::vector<std::int64_t> data(memoryN);
+    std::iota(data.begin(), data.end(), std::int64_t{0});
+    std::vector<std::int64_t> scanned(memoryN);
+    std::vector<double> out(computeN);
+
+    Row compute{"parallelFor (compute)", {}};
+    Row reduce{"parallelReduce (memory)", {}};
+    Row scan{"parallelScan (memory)", {}};
+    for (const unsigned threads : counts) {
+        scl::ThreadPool pool(threads, true);
+        compute.seconds.push_back(bestSeconds(5, [&] {
+            scl::parallelFor(std::int64_t{0}, computeN, 0, [&](std::int64_t lo, std::int64_t hi) {
+                for (std::int64_t i = lo; i < hi; ++i) {
+                    out[i] = work(i);
+                }
+            }, pool);
+        }));
+        std::int64_t sink = 0;
+        reduce.seconds.push_back(bestSeconds(5, [&] {
+            sink += scl::parallelReduce(std::int64_t{0}, memoryN, 0, std::int64_t{0}, [&](std::int64_t lo, std::int64_t hi) {
+                return std::accumulate(data.begin() + lo, data.begin() + hi, std::int64_t{0});
+            }, std::plus<>{}, pool);
+        }));
+        scan.seconds.push_back(bestSeconds(5, [&] {
+            scl::parallelScan(data.begin(), data.end(), 0, scanned.begin(), std::int64_t{0}, std::plus<>{}, pool);
+        }));
+        if (sink == 42) {
+            std::cout << ' ';
+        }
+    }
+
+    std::cout << std::left << std::setw(26) << "workers";
+    for (const unsigned threads : counts) {
+        std::cout << std::right << std::setw(24) << threads;
+    }
+    std::cout << '\n';
+    for (const Row* row : {&compute, &reduce, &scan}) {
+        std::cout << std::left << std::setw(26) << row->name << std::right << std::fixed;
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            const double speedup = row->seconds[0] / row->seconds[i];
+            std::cout << std::setw(9) << std::setprecision(2) << row->seconds[i] * 1e3 << " ms "
+                      << std::setw(5) << std::setprecision(1) << speedup << "x "
+                      << std::setw(3) << std::setprecision(0) << 100 * speedup / counts[i] << '%';
+        }
+        std::cout << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "scl/bitvector.hpp"
+#include "scl/wavelet.hpp"
+
+#include "check.hpp"
+
+namespace {
+
+using test::check;
+
+std::pair<std::size_t, std::size_t> randomRange(std::mt19937& rng, std::size_t n) {
+    std::size_t l = rng() % (n + 1);
+    std::size_t r = rng() % (n + 1);
+    if (l > r) {
+        std::swap(l, r);
+    }
+    return {l, r};
+}
+
+// `density` in [0, 1] is the chance of a one; the extremes exercise select
+// over long runs of a single value.
+void bitVector(std::size_t n, double density, std::mt19937& rng) {
+    std::bernoulli_distribution bit(density);
+    std::vector<bool> ref(n);
+    scl::BitVector bv(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ref[i] = bit(rng);
+        bv.set(i, ref[i]);
+    }
+    bv.build();
+
+    std::vector<std::size_t> ones, zeros;
+    std::vector<std::size_t> rank(n + 1);
+    bool ok = true;
+    for (std::size_t i = 0; i < n; ++i) {
+        ok &= bv[i] == ref[i];
+        (ref[i] ? ones : zeros).push_back(i);
+        rank[i + 1] = ones.size();
+    }
+    check(ok, "BitVector access");
+    check(bv.size() == n && bv.ones() == ones.size() && bv.zeros() == zeros.size(), "BitVector counts");
+
+    for (std::size_t i = 0; i <= n; ++i) {
+        ok &= bv.rank1(i) == rank[i] && bv.rank0(i) == i - rank[i];
+    }
+    check(ok, "BitVector rank");
+    for (std::size_t k = 0; k < ones.size(); ++k) {
+        ok &= bv.select1(k) == ones[k];
+    }
+    for (std::size_t k = 0; k < zeros.size(); ++k) {
+        ok &= bv.select0(k) == zeros[k];
+    }
+    check(ok, "BitVector select");
+}
+
+void selectInWord(std::mt19937& rng) {
+    bool ok = true;
+    for (int t = 0; t < 10000; ++t) {
+        const std::uint64_t x = (std::uint64_t{rng()} << 32 | rng()) & (std::uint64_t{rng()} << 32 | rng());
+        int k = 0;
+        for (int i = 0; i < 64; ++i) {
+            if ((x >> i) & 1) {
+                ok &= scl::selectInWord(x, k++) == i;
+            }
+        }
+    }
+    ok &= scl::selectInWord(~std::uint64_t{0}, 63) == 63;
+    check(ok, "selectInWord");
+}
+
+void waveletMatrix(std::size_t n, std::uint32_t sigma, std::mt19937& rng) {
+    std::vector<std::uint32_t> ref(n);
+    for (auto& x : ref) {
+        x = static_cast<std::uint32_t>(rng() % sigma);
+    }
+    const scl::WaveletMatrix<std::uint32_t> wm(ref);
+    check(wm.size() == n, "WaveletMatrix size");
+
+    bool ok = true;
+    for (std::size_t i = 0; i < n; ++i) {
+        ok &= wm.access(i) == ref[i];
+    }
+    check(ok, "WaveletMatrix access");
+
+    for (int q = 0; q < 500; ++q) {
+        const auto [l, r] = randomRange(rng, n);
+        // values past the largest one must be handled too
+        const auto value = static_cast<std::uint32_t>(rng() % (sigma + 2));
+        ok &= wm.rank(value, r) == static_cast<std::size_t>(std::count(ref.begin(), ref.begin() + r, value));
+
+        const auto lower = static_cast<std::uint32_t>(rng() % (sigma + 2));
+        const auto upper = static_cast<std::uint32_t>(rng() % (sigma + 2));
+        const auto freq = std::count_if(ref.begin() + l, ref.begin() + r, [&](std::uint32_t x) { return lower <= x && x < upper; });
+        ok &= wm.rangeFreq(l, r, lower, upper) == static_cast<std::size_t>(freq);
+
+        if (l == r) {
+            ok &= wm.topK(l, r, 3).empty();
+            continue;
+        }
+        std::vector<std::uint32_t> sorted(ref.begin() + l, ref.begin() + r);
+        std::ranges::sort(sorted);
+        const std::size_t k = rng() % sorted.size();
+        ok &= wm.kthSmallest(l, r, k) == sorted[k];
+        ok &= wm.kthLargest(l, r, k) == sorted[sorted.size() - 1 - k];
+
+        // ties make the order among equal counts unspecified, so compare
+        // the counts in order and each value against the reference count
+        std::map<std::uint32_t, std::size_t> counts;
+        for (const auto x : sorted) {
+            ++counts[x];
+        }
+        std::vector<std::size_t> expected;
+        for (const auto& [x, c] : counts) {
+            expected.push_back(c);
+        }
+        std::ranges::sort(expected, std::greater<>{});
+        const std::size_t want = rng() % 5 + 1;
+        const auto top = wm.topK(l, r, want);
+        ok &= top.size() == std::min(want, expected.size());
+        for (std::size_t i = 0; i < top.size(); ++i) {
+            ok &= top[i].second == expected[i] && counts[top[i].first] == top[i].second;
+        }
+    }
+    check(ok, "WaveletMatrix matches brute force");
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(3);
+    selectInWord(rng);
+    // sizes straddling the block (512), sample (4096) and superblock (2^16)
+    for (const std::size_t n : {std::size_t{0}, std::size_t{1}, std::size_t{63}, std::size_t{64}, std::size_t{513},
+                                std::size_t{5000}, std::size_t{70000}}) {
+        for (const double density : {0.0, 0.02, 0.5, 0.98, 1.0}) {
+            bitVector(n, density, rng);
+        }
+    }
+
+    for (const std::size_t n : {std::size_t{0}, std::size_t{1}, std::size_t{100}, std::size_t{3000}}) {
+        for (const std::uint32_t sigma : {1u, 2u, 7u, 256u, 100000u}) {
+            waveletMatrix(n, sigma, rng);
+        }
+    }
+    const scl::WaveletMatrix<std::uint8_t> bytes(std::vector<std::uint8_t>{255, 0, 255, 17});
+    check(bytes.access(0) == 255 && bytes.rank(255, 4) == 2 && bytes.kthSmallest(0, 4, 1) == 17, "WaveletMatrix over uint8_t");
+
+    return test::report("wavelet");
+}